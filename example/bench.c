@@ -0,0 +1,156 @@
+/*
+ * ISR cost benchmark for task_tick().
+ *
+ * Build once per engine (add -DTASK_CFG_READY_MASK=1 for the atomic ready
+ * mask) and compare the cycles/tick figures:
+ *   cc -O2 -I. -DTASK_CFG_ENGINE=TASK_ENGINE_MODULO    example/bench.c task.c -o bench_modulo
+ *   cc -O2 -I. -DTASK_CFG_ENGINE=TASK_ENGINE_COUNTDOWN example/bench.c task.c -o bench_countdown
+ *   cc -O2 -I. -DTASK_CFG_ENGINE=TASK_ENGINE_HEAP      example/bench.c task.c -o bench_heap
+ *
+ * -DBENCH_DYNAMIC=n adds n low-rate dynamic tasks (periods 1000..1000+n-1 ticks)
+ * next to the built-in ones; raise TASK_CFG_MAX_TASKS to match.
+ * -DBENCH_TIMERS=n (with -DTASK_CFG_TIMERS=1) keeps n one-shot timers armed on
+ * the timing wheel, each re-armed from its callback with a delay of 1..2048 ticks.
+ *
+ * The per-dispatch figure is the task_handler() time divided by the handler runs;
+ * the schedule itself is checked by example/sim.c.
+ *
+ * On target, define BENCH_CYCLES() to a free-running cycle counter
+ * (e.g. DWT->CYCCNT on Cortex-M3/M4/M7, or a down-counting SysTick->VAL read
+ * negated on Cortex-M0) and BENCH_PRINT to your logging function.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include "task.h"
+
+#ifndef BENCH_TICKS
+#define BENCH_TICKS (100000UL)
+#endif
+
+#ifndef BENCH_CYCLES
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES() ((uint64_t)__rdtsc())
+#elif defined(__aarch64__)
+static inline uint64_t bench_cntvct(void)
+{
+    uint64_t v;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+}
+#define BENCH_CYCLES() bench_cntvct()
+#else
+#include <time.h>
+#define BENCH_CYCLES() ((uint64_t)clock())
+#endif
+#endif
+
+#ifndef BENCH_PRINT
+#define BENCH_PRINT printf
+#endif
+
+#ifndef BENCH_DYNAMIC
+#define BENCH_DYNAMIC (0)
+#endif
+
+#ifndef BENCH_TIMERS
+#define BENCH_TIMERS (0)
+#endif
+
+static volatile uint32_t bench_runs;
+
+#if (BENCH_DYNAMIC > 0)
+static task_tcb_t bench_pool[BENCH_DYNAMIC];
+#endif
+
+static void bench_handler(void)
+{
+    bench_runs++;
+}
+
+#if (BENCH_TIMERS > 0)
+static task_timer_t bench_timers[BENCH_TIMERS];
+static uint32_t bench_seed = 1;
+static uint32_t bench_expiries;
+
+static uint32_t bench_delay(void)
+{
+    bench_seed = (bench_seed * 1103515245UL) + 12345UL;
+    return 1U + ((bench_seed >> 16) & 2047U);
+}
+
+static void bench_timer(uintptr_t index)
+{
+    bench_expiries++;
+    task_timer_start(&bench_timers[index], bench_delay());
+}
+#endif
+
+int main(void)
+{
+    for (uint8_t i = 0; i < TASK_COUNT; i++)
+    {
+        task_register_handler((task_type_t)i, bench_handler);
+    }
+
+#if (BENCH_DYNAMIC > 0)
+    task_pool_init(bench_pool, BENCH_DYNAMIC);
+
+    for (uint32_t i = 0; i < BENCH_DYNAMIC; i++)
+    {
+        task_add(1000U + i, i, bench_handler);
+    }
+#endif
+
+#if (BENCH_TIMERS > 0)
+    for (uint32_t i = 0; i < BENCH_TIMERS; i++)
+    {
+        task_timer_init(&bench_timers[i], bench_timer, i);
+        task_timer_start(&bench_timers[i], bench_delay());
+    }
+#endif
+
+    // Warm up caches and branch predictors over one full second of ticks
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        task_tick();
+        task_handler();
+    }
+
+    uint64_t tick_cycles = 0;
+    uint64_t handler_cycles = 0;
+    uint32_t runs_before = bench_runs;
+
+    for (uint32_t i = 0; i < BENCH_TICKS; i++)
+    {
+        uint64_t t0 = BENCH_CYCLES();
+        task_tick();
+        uint64_t t1 = BENCH_CYCLES();
+        task_handler();
+        uint64_t t2 = BENCH_CYCLES();
+
+        tick_cycles += t1 - t0;
+        handler_cycles += t2 - t1;
+    }
+
+    BENCH_PRINT("engine=%s ready=%s tasks=%lu ticks=%lu runs=%lu\n",
+                (TASK_CFG_ENGINE == TASK_ENGINE_MODULO) ? "modulo" :
+                (TASK_CFG_ENGINE == TASK_ENGINE_COUNTDOWN) ? "countdown" : "heap",
+                (TASK_CFG_READY_MASK != 0) ? "mask" : "flags",
+                (unsigned long)(TASK_COUNT + BENCH_DYNAMIC),
+                (unsigned long)BENCH_TICKS, (unsigned long)bench_runs);
+    BENCH_PRINT("task_tick()    : %lu cycles/call\n", (unsigned long)(tick_cycles / BENCH_TICKS));
+    BENCH_PRINT("task_handler() : %lu cycles/call\n", (unsigned long)(handler_cycles / BENCH_TICKS));
+
+    if (bench_runs != runs_before)
+    {
+        BENCH_PRINT("dispatch       : %lu cycles/handler run\n",
+                    (unsigned long)(handler_cycles / (bench_runs - runs_before)));
+    }
+#if (BENCH_TIMERS > 0)
+    BENCH_PRINT("timers=%lu wheel=%lu expiries=%lu\n", (unsigned long)BENCH_TIMERS,
+                (unsigned long)TASK_CFG_TIMER_WHEEL, (unsigned long)bench_expiries);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * Host backend demo: the example tasks on a timer thread and a worker pool.
+ *
+ *   cc -O2 -pthread -I. -DTASK_CFG_READY_MASK=1 -DTASK_CFG_HOST_WORKERS=4 \
+ *      example/host.c task.c task_host.c task_clock.c -o host
+ *
+ * The 1Hz handler takes 300ms; the 100Hz task keeps its rate on the other workers.
+ */
+#include <stdio.h>
+#include "task_host.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#define HOST_SLEEP_MS(ms) Sleep(ms)
+#else
+#include <time.h>
+static void host_sleep_ms(unsigned ms)
+{
+    struct timespec ts = { (time_t)(ms / 1000U), (long)(ms % 1000U) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+#define HOST_SLEEP_MS(ms) host_sleep_ms(ms)
+#endif
+
+static volatile unsigned runs_100hz;
+
+static void app_1hz_handler(void)
+{
+    printf("[1Hz]   Task running, 100Hz runs so far: %u\n", runs_100hz);
+    HOST_SLEEP_MS(300);                   // slow job, blocks only its own worker
+}
+
+static void app_10hz_handler(void)
+{
+    printf("[10Hz]  Task running\n");
+}
+
+static void app_100hz_handler(void)
+{
+    runs_100hz++;
+}
+
+int main(void)
+{
+    task_register_handler(TASK_1HZ, app_1hz_handler);
+    task_register_handler(TASK_10HZ, app_10hz_handler);
+    task_register_handler(TASK_100HZ, app_100hz_handler);
+
+    if (task_host_start() != 0)
+    {
+        printf("Could not start the host backend\n");
+        return 1;
+    }
+
+    HOST_SLEEP_MS(5000);
+    task_host_stop();
+
+    printf("100Hz runs: %u (500 expected), overflows: %lu\n", runs_100hz,
+           (unsigned long)task_get_overflow_count(task_get(TASK_100HZ)));
+
+    return 0;
+}
@@ -1,6 +1,6 @@
 #include <stdio.h>
-#include <windows.h>
 #include "task.h"
+#include "task_clock.h"
 
 static void app_1hz_handler(void)
 {
@@ -19,6 +19,8 @@ static void app_100hz_handler(void)
 
 int main(void)
 {
+    task_clock_t tick_source;
+
     // Register a few task handlers
     task_register_handler(TASK_1HZ, app_1hz_handler);
     task_register_handler(TASK_10HZ, app_10hz_handler);
@@ -26,12 +28,21 @@ int main(void)
 
     printf("Task Scheduler Simulation (CTRL+C to exit)\n");
 
+    // Ticks (1ms by default) on absolute deadlines: oversleeping is caught up instead of drifting
+    task_clock_init(&tick_source, TASK_TICK_NS, 0);
+
     while (1)
     {
-        task_tick();    // Simulate 1ms timer tick
-        task_handler(); // Run any ready tasks
-
-        Sleep(1); // Delay ~1ms
+        task_clock_sleep(&tick_source);     // Wait for the next tick deadline
+        task_clock_poll(&tick_source);      // Simulate the timer ticks that elapsed
+        task_handler();                     // Run any ready tasks
+
+        if ((tick_source.ticks % (10U * TASK_TICK_HZ)) == 0U)
+        {
+            printf("ticks=%lu caught_up=%lu lost=%lu max_lag=%luus\n",
+                   (unsigned long)tick_source.ticks, (unsigned long)tick_source.caught_up,
+                   (unsigned long)tick_source.lost, (unsigned long)(tick_source.max_lag_ns / 1000U));
+        }
     }
 
     return 0;
@@ -0,0 +1,410 @@
+/*
+ * Deterministic schedule check on a virtual clock.
+ *
+ * Runs the built-in frequencies plus a few dynamic tasks for SIM_TICKS virtual
+ * ticks, without wall-clock time or threads, and checks the schedule against
+ * the arithmetic one (tick % period == phase):
+ *   1. zero-cost handlers: every release runs on its own tick, no overflow
+ *   2. synthetic costs: a handler "runs" for some ticks, during which task_tick()
+ *      interrupts it as the timer would. Every release must either run or be
+ *      counted as an overflow (or as shed, task_get_shed_count()), and the start
+ *      jitter is reported per task
+ *
+ * The trace hash covers every (tick, task) run, so two builds replay the same
+ * schedule if and only if they print the same hash. Exit status 1 on failure.
+ *   cc -O2 -I. example/sim.c task.c -o sim && ./sim
+ *   cc -O2 -I. -DTASK_CFG_ENGINE=TASK_ENGINE_HEAP -DTASK_CFG_READY_MASK=1 example/sim.c task.c -o sim
+ *
+ * Phase 2 delivers SIM_BATCH ticks per main loop pass. With SIM_TICK_N=1 every run
+ * of ticks between two handler calls is one task_tick_n() call instead of single
+ * task_tick() calls; both builds must print the same hashes. With TASK_CFG_SHED the
+ * dynamic tasks are low / medium criticality, so the overload of phase 2 sheds them.
+ * A level reached inside a task_tick_n() call applies from the next call, so phase 2
+ * may differ between the two builds then; phase 3 checks the shed level after batches
+ * of several windows, which both builds must reach exactly like single ticks:
+ *   cc -O2 -I. -DTASK_CFG_RETUNE=1 -DTASK_CFG_SHED=1 -DSIM_BATCH=40 example/sim.c task.c -o sim
+ *   cc -O2 -I. -DTASK_CFG_RETUNE=1 -DTASK_CFG_SHED=1 -DSIM_BATCH=40 -DSIM_TICK_N=1 example/sim.c task.c -o sim
+ *
+ * With TASK_CFG_ANALYSIS phase 4 replaces the tasks by three with fixed costs, one
+ * cycle per tick, and checks every bound of task_analyze() within its period against
+ * the run. In index order the fast task is released while the slow ones run in the
+ * same task_handler() pass, so it overflows and its bound must say so:
+ *   cc -O2 -I. -DTASK_CFG_ANALYSIS=1 -DTASK_CFG_CYCLES_HZ=1000 example/sim.c task.c -o sim
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include "task.h"
+
+#ifndef SIM_TICKS
+#define SIM_TICKS (200000UL)
+#endif
+
+#ifndef SIM_SEED
+#define SIM_SEED (12345UL)
+#endif
+
+#ifndef SIM_BATCH
+#define SIM_BATCH (1UL)
+#endif
+
+#ifndef SIM_TICK_N
+#define SIM_TICK_N (0)
+#endif
+
+#define SIM_DYNAMIC (6U)
+#define SIM_TASKS   (TASK_COUNT + SIM_DYNAMIC)
+
+typedef struct
+{
+    task_tcb_t *tcb;
+    uint32_t period;
+    uint32_t phase;
+    uint32_t runs;
+    uint32_t max_jitter;                  // Ticks from the latest release to the handler start
+    uint32_t overflow_base;               // Overflow count at the start of the phase
+    uint32_t cost;                        // Ticks every run takes (phase 4)
+#if (TASK_CFG_SHED != 0)
+    uint32_t shed_base;                   // Shed count at the start of the phase
+#endif
+} sim_task_t;
+
+static const uint32_t sim_periods[SIM_DYNAMIC] = { 3, 7, 16, 45, 250, 1500 };
+static const uint32_t sim_phases[SIM_DYNAMIC]  = { 0, 2, 5, 44, 125, 700 };
+
+static task_tcb_t sim_pool[SIM_DYNAMIC];
+static sim_task_t sim[SIM_TASKS];
+static uint32_t sim_now;                  // Virtual clock, in ticks
+static uint32_t sim_seed = SIM_SEED;
+static uint8_t sim_costs;                 // Phase 2: handlers consume virtual time
+static uint64_t sim_hash = 1469598103934665603ULL;
+static int sim_failed;
+
+static uint32_t sim_random(void)
+{
+    sim_seed = (sim_seed * 1103515245UL) + 12345UL;
+    return (sim_seed >> 16) & 0x7FFFU;
+}
+
+// Deliver `count` ticks with no handler in between, as single ticks or one batch
+static void sim_tick(uint32_t count)
+{
+#if (SIM_TICK_N != 0)
+    sim_now += count;
+    task_tick_n(count);
+#else
+    for (; count != 0U; count--)
+    {
+        sim_now++;
+        task_tick();
+    }
+#endif
+}
+
+// Common handler body: trace the run, measure the jitter, then spend the synthetic cost
+static void sim_run(uint8_t id)
+{
+    sim_task_t *t = &sim[id];
+    uint32_t jitter = (sim_now + t->period - t->phase) % t->period;
+
+    t->runs++;
+
+    if (jitter > t->max_jitter)
+    {
+        t->max_jitter = jitter;
+    }
+
+    // FNV-1a over the run trace
+    sim_hash = (sim_hash ^ ((uint64_t)sim_now << 8) ^ id) * 1099511628211ULL;
+
+    if (sim_costs)
+    {
+        // Mostly short runs, now and then one longer than the fastest periods
+        uint32_t cost = ((sim_random() % 16U) == 0U) ? (sim_random() % 8U) : 0U;
+
+        sim_tick(cost);
+    }
+
+    sim_tick(t->cost);
+}
+
+#define SIM_HANDLER(n) static void sim_handler_##n(void) { sim_run(n); }
+SIM_HANDLER(0)  SIM_HANDLER(1)  SIM_HANDLER(2)  SIM_HANDLER(3)  SIM_HANDLER(4)
+SIM_HANDLER(5)  SIM_HANDLER(6)  SIM_HANDLER(7)  SIM_HANDLER(8)  SIM_HANDLER(9)
+SIM_HANDLER(10) SIM_HANDLER(11) SIM_HANDLER(12) SIM_HANDLER(13)
+
+static const task_handler_cb_t sim_handlers[SIM_TASKS] =
+{
+    sim_handler_0,  sim_handler_1,  sim_handler_2,  sim_handler_3,  sim_handler_4,
+    sim_handler_5,  sim_handler_6,  sim_handler_7,  sim_handler_8,  sim_handler_9,
+    sim_handler_10, sim_handler_11, sim_handler_12, sim_handler_13
+};
+
+// Releases of a task on ticks from+1 .. to
+static uint32_t sim_expected(const sim_task_t *t, uint32_t from, uint32_t to)
+{
+    uint32_t upto = (to + t->period - t->phase) / t->period;
+    uint32_t before = (from + t->period - t->phase) / t->period;
+
+    return upto - before;
+}
+
+static void sim_check(const char *what, uint32_t got, uint32_t want, uint8_t id)
+{
+    if (got != want)
+    {
+        printf("FAIL %s task %u: %lu, expected %lu\n", what, id, (unsigned long)got, (unsigned long)want);
+        sim_failed = 1;
+    }
+}
+
+// Run `ticks` virtual ticks, `batch` per main loop pass, then let the main loop finish what is still pending
+static void sim_phase(uint32_t ticks, uint32_t batch)
+{
+    uint32_t end = sim_now + ticks;
+
+    while (sim_now < end)
+    {
+        sim_tick(batch);
+        task_handler();
+    }
+
+    sim_costs = 0;
+
+    while (task_pending())
+    {
+        task_handler();
+    }
+}
+
+#if (TASK_CFG_SHED != 0)
+#define SIM_SHED_LEVELS (4U)              // Low and medium criticality, two steps each
+
+static void sim_check_level(const char *what, uint8_t want)
+{
+    if (task_get_shed_level() != want)
+    {
+        printf("FAIL shed level after %s: %u, expected %u\n", what, task_get_shed_level(), want);
+        sim_failed = 1;
+    }
+}
+
+// Suspend or resume every task; suspending also runs what is still pending
+static void sim_suspend_all(uint8_t suspend)
+{
+    for (uint8_t i = 0; i < SIM_TASKS; i++)
+    {
+        if (suspend)
+        {
+            task_suspend(sim[i].tcb);
+        }
+        else
+        {
+            task_resume(sim[i].tcb);
+        }
+    }
+
+    while (task_pending())
+    {
+        task_handler();
+    }
+}
+
+// Phase 3: shed and restore over batches of whole windows, from a window boundary
+static void sim_shed_phase(void)
+{
+    // Every tick passed the window count, so the open window started at a multiple
+    sim_suspend_all(1);
+    sim_tick(TASK_CFG_SHED_WINDOW - (sim_now % TASK_CFG_SHED_WINDOW));
+
+    // Calm windows only: the level drops to 0 and the calm count restarts
+    sim_tick(SIM_SHED_LEVELS * TASK_CFG_SHED_RECOVER * TASK_CFG_SHED_WINDOW);
+    sim_check_level("calm batch", 0);
+
+    // No handler for three windows: each one overflows and sheds one step deeper
+    sim_suspend_all(0);
+    sim_tick(3U * TASK_CFG_SHED_WINDOW);
+    sim_check_level("overloaded batch", 3);
+
+    // Two recoveries' worth of calm windows bring it back two steps
+    sim_suspend_all(1);
+    sim_tick(2U * TASK_CFG_SHED_RECOVER * TASK_CFG_SHED_WINDOW);
+    sim_check_level("partial calm batch", 1);
+
+    sim_tick(TASK_CFG_SHED_RECOVER * TASK_CFG_SHED_WINDOW);
+    sim_check_level("restore", 0);
+    sim_suspend_all(0);
+
+    printf("phase 3: shed levels checked over batches of %lu windows\n",
+           (unsigned long)(SIM_SHED_LEVELS * TASK_CFG_SHED_RECOVER));
+}
+#endif
+
+#if (TASK_CFG_ANALYSIS != 0)
+#define SIM_PASS_TASKS (3U)
+#define SIM_PASS_TICKS (10000UL)
+
+// The slow tasks release on tick 9, the fast one on tick 10, just after the handler went by it
+static const uint32_t sim_pass_periods[SIM_PASS_TASKS] = { 10, 100, 100 };
+static const uint32_t sim_pass_phases[SIM_PASS_TASKS]  = { 0, 9, 9 };
+static const uint32_t sim_pass_costs[SIM_PASS_TASKS]   = { 1, 6, 6 };
+
+// Phase 4: bounds of task_analyze() against a run with fixed costs, one cycle per tick
+static void sim_analysis_phase(void)
+{
+    task_analysis_t report;
+
+    // Last first: the pool hands out the latest removed block first, so the fast task gets the lowest index
+    for (uint8_t i = SIM_TASKS; i-- != 0U;)
+    {
+        if (i < TASK_COUNT)
+        {
+            task_register_handler((task_type_t)i, NULL);
+        }
+        else
+        {
+            task_remove(sim[i].tcb);
+        }
+    }
+
+    for (uint8_t k = 0; k < SIM_PASS_TASKS; k++)
+    {
+        sim_task_t *t = &sim[TASK_COUNT + k];
+
+        t->period = sim_pass_periods[k];
+        t->phase = sim_pass_phases[k];
+        t->cost = sim_pass_costs[k];
+        t->tcb = task_add(t->period, t->phase, sim_handlers[TASK_COUNT + k]);
+        t->runs = 0;
+        t->max_jitter = 0;
+        t->overflow_base = task_get_overflow_count(t->tcb);
+        task_set_wcet(t->tcb, t->cost);
+    }
+
+    uint8_t ok = task_analyze(&report);
+
+    sim_phase(SIM_PASS_TICKS, 1);
+
+    printf("phase 4: %s, %u tasks may miss\n", ok ? "schedulable" : "not schedulable", report.misses);
+    printf("task period bound response overflows\n");
+
+    for (uint8_t k = 0; k < SIM_PASS_TASKS; k++)
+    {
+        sim_task_t *t = &sim[TASK_COUNT + k];
+        uint64_t bound = task_get_response_time(t->tcb);
+        uint32_t overflows = task_get_overflow_count(t->tcb) - t->overflow_base;
+        uint32_t response = t->max_jitter + t->cost;
+
+        // A bound within the period must hold; under EDF it is a demand bound, the deadline must hold
+        if (bound <= t->period)
+        {
+            sim_check("overflows within the bound", overflows, 0, TASK_COUNT + k);
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_EDF)
+            sim_check("response after the deadline", response > t->period, 0, TASK_COUNT + k);
+#else
+            sim_check("response above the bound", response > bound, 0, TASK_COUNT + k);
+#endif
+        }
+
+        printf("%4u %6lu %5llu %8lu %9lu\n", TASK_COUNT + k, (unsigned long)t->period, (unsigned long long)bound,
+               (unsigned long)response, (unsigned long)overflows);
+    }
+}
+#endif
+
+static void sim_reset(void)
+{
+    for (uint8_t i = 0; i < SIM_TASKS; i++)
+    {
+        sim[i].runs = 0;
+        sim[i].max_jitter = 0;
+        sim[i].overflow_base = task_get_overflow_count(sim[i].tcb);
+#if (TASK_CFG_SHED != 0)
+        sim[i].shed_base = task_get_shed_count(sim[i].tcb);
+#endif
+    }
+}
+
+int main(void)
+{
+    static const uint32_t rate_periods[TASK_COUNT] =
+    {
+        TASK_HZ_TO_TICKS(1), TASK_HZ_TO_TICKS(2), TASK_HZ_TO_TICKS(5), TASK_HZ_TO_TICKS(10),
+        TASK_HZ_TO_TICKS(20), TASK_HZ_TO_TICKS(50), TASK_HZ_TO_TICKS(100), TASK_HZ_TO_TICKS(200)
+    };
+
+    task_pool_init(sim_pool, SIM_DYNAMIC);
+
+    for (uint8_t i = 0; i < SIM_TASKS; i++)
+    {
+        if (i < TASK_COUNT)
+        {
+            sim[i].period = rate_periods[i];
+            sim[i].phase = 0;
+            task_register_handler((task_type_t)i, sim_handlers[i]);
+            sim[i].tcb = task_get((task_type_t)i);
+        }
+        else
+        {
+            sim[i].period = sim_periods[i - TASK_COUNT];
+            sim[i].phase = sim_phases[i - TASK_COUNT];
+            sim[i].tcb = task_add(sim[i].period, sim[i].phase, sim_handlers[i]);
+#if (TASK_CFG_SHED != 0)
+            task_set_criticality(sim[i].tcb, ((i & 1U) != 0U) ? TASK_CRIT_LOW : TASK_CRIT_MEDIUM);
+#endif
+        }
+    }
+
+    // Phase 1: ideal handlers, the schedule must match exactly
+    uint32_t from = sim_now;
+
+    sim_reset();
+    sim_phase(SIM_TICKS, 1);
+
+    for (uint8_t i = 0; i < SIM_TASKS; i++)
+    {
+        sim_check("runs", sim[i].runs, sim_expected(&sim[i], from, sim_now), i);
+        sim_check("jitter", sim[i].max_jitter, 0, i);
+        sim_check("overflows", task_get_overflow_count(sim[i].tcb) - sim[i].overflow_base, 0, i);
+    }
+
+    printf("phase 1: %lu ticks, trace hash %016llx\n", (unsigned long)SIM_TICKS, (unsigned long long)sim_hash);
+
+    // Phase 2: synthetic costs, every release is either run or counted as an overflow
+    from = sim_now;
+    sim_costs = 1;
+
+    sim_reset();
+    sim_phase(SIM_TICKS, SIM_BATCH);
+
+    printf("phase 2: %lu ticks, trace hash %016llx\n", (unsigned long)(sim_now - from), (unsigned long long)sim_hash);
+    printf("task period phase     runs overflows max_jitter\n");
+
+    for (uint8_t i = 0; i < SIM_TASKS; i++)
+    {
+        uint32_t overflows = task_get_overflow_count(sim[i].tcb) - sim[i].overflow_base;
+
+#if (TASK_CFG_SHED != 0)
+        // Shed tasks lose releases without an overflow, counted apart
+        uint32_t shed = task_get_shed_count(sim[i].tcb) - sim[i].shed_base;
+
+        sim_check("runs + overflows + shed", sim[i].runs + overflows + shed,
+                  sim_expected(&sim[i], from, sim_now), i);
+#else
+        sim_check("runs + overflows", sim[i].runs + overflows, sim_expected(&sim[i], from, sim_now), i);
+#endif
+
+        printf("%4u %6lu %5lu %8lu %9lu %10lu\n", i, (unsigned long)sim[i].period, (unsigned long)sim[i].phase,
+               (unsigned long)sim[i].runs, (unsigned long)overflows, (unsigned long)sim[i].max_jitter);
+    }
+
+#if (TASK_CFG_SHED != 0)
+    printf("shed level %u\n", task_get_shed_level());
+    sim_shed_phase();
+#endif
+#if (TASK_CFG_ANALYSIS != 0)
+    sim_analysis_phase();
+#endif
+    printf("%s\n", sim_failed ? "FAIL" : "PASS");
+
+    return sim_failed;
+}
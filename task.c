@@ -5,60 +5,218 @@
  * Version     : 1.0.0
  * Description : Task Frequency Scheduler Module
  *
- * This module provides a lightweight cooperative task scheduler based on a fixed 1ms system tick.
+ * This module provides a lightweight cooperative task scheduler based on a periodic system tick
+ * (TASK_CFG_TICK_HZ, 1ms by default).
  * It manages multiple periodic tasks at predefined frequencies (1Hz to 200Hz) using a simple
  * flag mechanism and user-registered callback functions.
  *
  * Features:
  *  - Fixed frequency task execution: 1Hz, 2Hz, 5Hz, 10Hz, 20Hz, 50Hz, 100Hz, 200Hz
  *  - Efficient tick-based scheduling with minimal overhead
+ *  - Dynamic tasks with arbitrary periods and phase offsets from a static, user-provided pool
+ *  - Selectable tick engine: division-free countdowns (default), the classic modulo scan,
+ *    or a release heap that only touches due tasks (hundreds of low-rate jobs)
  *  - Task overflow detection (missed execution)
- *  - Flexible handler registration using function pointers
+ *  - Optional lock-free event queues for deferred work posted from interrupts
+ *  - Optional one-shot timers on a hashed timing wheel, O(1) start and cancel
+ *  - Optional sliced tasks: 1/N of the work on each of N ticks spread over the period
+ *  - Optional pipelines: stages chained after a task run back to back in the same pass
+ *  - Optional per-task overrun policy: coalesce, bounded catch-up bursts, or skip
+ *  - Optional per-task execution budget, checked from the tick with an overrun hook
+ *  - Optional lock-free ready bitmask between the tick ISR and the main loop
+ *  - Tickless operation: next release query and multi-tick catch-up after sleep
+ *  - Batched ticks: `task_tick_n()` advances any number of ticks at a cost independent of the count
+ *  - Optional execution time / latency statistics with histograms
+ *  - Optional interrupt safe period changes and suspension, applied at the next release
+ *  - Optional mixed-criticality load shedding: low criticality tasks slowed, then suspended, under overload
+ *  - Optional idle hook and sliced background jobs, with per-task and overall CPU load accounting
+ *  - Optional binary event trace ring (release, start, end, overflow), decoded on the host
+ *  - Index, rate monotonic or earliest deadline first dispatch order
+ *  - Optional preemptive execution of the most urgent levels from software interrupts
+ *  - Phase staggering to spread releases over the hyperperiod, with worst-case load report
+ *  - Optional schedulability analysis: response-time bounds, utilisation and admission tests
+ *  - One scheduler instance per core with pinned tasks and lock-free stealing of pending work
+ *  - Configurable tick rate with a 64-bit monotonic time base
+ *  - Placement of the tick / dispatch path in fast memory, cache-line split of ISR and main loop state
+ *  - Flexible handler registration using function pointers, optionally with a context pointer
  *
  * Usage:
- *  - Call `task_tick()` from a 1ms tick interrupt or timer
+ *  - Call `task_tick()` from a TASK_CFG_TICK_HZ tick interrupt or timer (1ms by default)
  *  - Call `task_handler()` periodically from the main loop
- *  - Use `task_register_handle()` to assign handlers for each task frequency
- *  - Monitor execution reliability with `task_overflow_count`
+ *  - Use `task_register_handler()` to assign handlers for each task frequency
+ *  - Use `task_pool_init()` once, then `task_add()`/`task_remove()` for any other period
+ *  - Sliced work: `task_add_sliced(TASK_HZ_TO_TICKS(1), 0, 64, scan_sensor)` calls `scan_sensor(0..63)`
+ *  - Pipelines: `task_add_stage()` per stage, `task_chain(before, after, &edge)` per dependency
+ *  - One handler for many instances: `task_add_ctx(period, phase, motor_loop, &motor[i])`
+ *  - Events: `task_queue_init()` + `task_queue_attach()` once, `task_queue_post()` from one ISR per queue
+ *  - Timers: `task_timer_init()` once, `task_timer_start()` to (re)arm, `task_timer_cancel()`
+ *  - Periods in time units: `task_add(TASK_US_TO_TICKS(500), 0, loop)`, time base `task_time_us()`
+ *  - Retune at run time, also from interrupts: `task_set_period()`, `task_suspend()`, `task_resume()`
+ *  - Shedding: `task_set_criticality(task, TASK_CRIT_LOW)` after registration for the tasks that may degrade
+ *  - Tickless: sleep for `task_ticks_to_next()` ticks, then report the slept time to `task_advance()`
+ *  - Monitor execution reliability with `task_get_overflow_count()` and `task_get_stats()`
+ *  - Analysis: `task_analyze()` after a measurement run, `task_admit(period, wcet, NULL)` before `task_add()`
+ *  - Idle: `task_register_idle_hook()` for WFI, `task_job_start()` for background work that polls
+ *    `task_should_yield()`, `task_get_load()` for utilisation
+ *  - Trace: `task_trace_init()` once, stream `task_trace_read()` output, decode with tools/task_trace.py
+ *  - Multi-core: every core runs its own tick and handler loop, idle cores call `task_steal()`
  *
  * Limitations:
- *  - Only one handler per task frequency (no multi-handler support)
+ *  - Only one handler per built-in task frequency (use `task_add()` for more handlers per period)
  *  - Tasks must execute quickly to avoid flag overflows
+ *  - The modulo engine glitches once when the free running tick counter wraps (2^32 ticks)
  *
  ******************************************************************************/
 
 /* Includes ------------------------------------------------------------------*/
 #include "task.h"
+#include "task_port.h"
 
 /* Defines/macros ------------------------------------------------------------*/
 
-// Tick thresholds for each frequency (assuming 1ms tick)
-#define TICK_1HZ     (1000)
-#define TICK_2HZ     (500)
-#define TICK_5HZ     (200)
-#define TICK_10HZ    (100)
-#define TICK_20HZ    (50)
-#define TICK_50HZ    (20)
-#define TICK_100HZ   (10)
-#define TICK_200HZ   (5)
+// Tick thresholds for each frequency
+#define TICK_1HZ     (TASK_CFG_TICK_HZ / 1U)
+#define TICK_2HZ     (TASK_CFG_TICK_HZ / 2U)
+#define TICK_5HZ     (TASK_CFG_TICK_HZ / 5U)
+#define TICK_10HZ    (TASK_CFG_TICK_HZ / 10U)
+#define TICK_20HZ    (TASK_CFG_TICK_HZ / 20U)
+#define TICK_50HZ    (TASK_CFG_TICK_HZ / 50U)
+#define TICK_100HZ   (TASK_CFG_TICK_HZ / 100U)
+#define TICK_200HZ   (TASK_CFG_TICK_HZ / 200U)
+
+// Ready mask words needed to give every task its own bit
+#define TASK_READY_WORDS    ((TASK_CFG_MAX_TASKS + 31U) / 32U)
+
+// Ready mask levels: one per priority for rate monotonic dispatch, otherwise a single level
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+#define TASK_READY_LEVELS   (TASK_CFG_PRIORITY_LEVELS)
+#else
+#define TASK_READY_LEVELS   (1U)
+#endif
+
+// Levels dispatched from software interrupts instead of task_handler()
+#if (TASK_CFG_PREEMPT_LEVELS >= 32)
+#define TASK_PREEMPT_MASK   (0xFFFFFFFFUL)
+#else
+#define TASK_PREEMPT_MASK   ((1UL << TASK_CFG_PREEMPT_LEVELS) - 1UL)
+#endif
+
+// Bit of a task index within its ready mask word
+#define TASK_READY_BIT(index)   (1UL << ((index) & 31U))
+
+// Load shedding: per-task degradation, and the deepest shed level (medium suspended)
+#define TASK_SHED_NONE          (0U)
+#define TASK_SHED_HALF          (1U)
+#define TASK_SHED_SUSPEND       (2U)
+#define TASK_SHED_LEVELS        (2U * (uint8_t)TASK_CRIT_HIGH)
+
+// Several cores or host workers may claim tasks of one instance, so handlers need a busy guard
+#if (TASK_CFG_CORES > 1) || (TASK_CFG_HOST_WORKERS > 1)
+#define TASK_BUSY_GUARD     (1)
+#else
+#define TASK_BUSY_GUARD     (0)
+#endif
+
+#if (TASK_CFG_MAX_TASKS < TASK_COUNT) || (TASK_CFG_MAX_TASKS > 0xFFFF)
+#error "task.c: TASK_CFG_MAX_TASKS must cover the built-in frequencies and fit a uint16_t index"
+#endif
 
 /* Types ---------------------------------------------------------------------*/
 
 /**
  * @brief Main scheduler structure to hold all dynamic state variables.
+ *
+ * Split in two groups by writer, each starting on its own cache line with
+ * TASK_CFG_CACHE_LINE, so the tick interrupt and the main loop (or another
+ * core stealing work) do not invalidate each other's lines.
  */
 typedef struct
 {
-    uint32_t tick_count;                           // Global tick counter
-    volatile uint8_t flags[TASK_COUNT];            // Execution flags
-    uint8_t overflow_count[TASK_COUNT];            // Missed deadline counters
-    task_handler_cb_t handler_cb[TASK_COUNT];      // Function pointers
+    /* Written by task_tick() */
+    TASK_CACHE_ALIGNED uint32_t tick_count;        // Global tick counter (free running)
+    uint32_t tick_epoch;                           // Wraps of tick_count, upper word of task_time()
+#if (TASK_CFG_READY_MASK != 0)
+    TASK_ATOMIC_U32 ready[TASK_READY_LEVELS][TASK_READY_WORDS]; // Execution flags, bit n = task index n
+#endif
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+    TASK_ATOMIC_U32 ready_levels;                  // Bit l = level l may have a pending task
+#endif
+#if (TASK_CFG_ENGINE == TASK_ENGINE_HEAP)
+    task_tcb_t *heap[TASK_CFG_MAX_TASKS];          // Scheduled tasks, min-heap on `due`
+    uint16_t heap_count;                           // Number of tasks in the heap
+#endif
+#if (TASK_CFG_TIMERS != 0)
+    task_timer_t *wheel[TASK_CFG_TIMER_WHEEL];     // Armed timers, hashed on expiry tick
+    task_timer_t *expired;                         // Expired timers, callbacks pending
+    task_timer_t **expired_tail;                   // Last link of the expired list
+#endif
+#if (TASK_CFG_SHED != 0)
+    uint32_t shed_overflows;                       // Overflows in the current window
+    uint32_t shed_elapsed;                         // Ticks of the current window so far
+    uint8_t shed_level;                            // Degradation step, 0 = full rates
+    uint8_t shed_calm;                             // Consecutive windows without overflow
+#endif
+#if (TASK_CFG_TRACE != 0)
+    task_trace_event_t *trace;                     // Trace ring, NULL while tracing is off
+    uint32_t trace_mask;                           // Ring capacity - 1
+    uint32_t trace_head;                           // Events recorded so far
+    uint32_t trace_tail;                           // Events taken by task_trace_read()
+#endif
+
+    /* Written by the main loop, read by task_tick() */
+    TASK_CACHE_ALIGNED task_tcb_t *active;         // Scheduled tasks, sorted by index
+    task_tcb_t *free;                              // Unused pool blocks
+    task_tcb_t *pool;                              // Dynamic task storage (index TASK_COUNT..)
+    uint16_t pool_count;                           // Number of blocks in the pool
+    uint16_t active_count;                         // Number of scheduled tasks
+#if (TASK_CFG_CORES > 1)
+    TASK_ATOMIC_U32 stealable[TASK_READY_WORDS];   // Bit n = task index n may run on another core
+#endif
+#if (TASK_BUSY_GUARD != 0)
+    TASK_ATOMIC_U32 running[TASK_READY_WORDS];     // Bit n = handler of task index n is executing
+#endif
+#if (TASK_CFG_EVENTS != 0)
+    task_queue_t *queues;                          // Event queues drained by task_handler()
+#endif
+#if (TASK_CFG_BUDGET != 0)
+    task_budget_hook_t budget_hook;                // Called on a budget overrun
+#if (TASK_BUSY_GUARD == 0)
+    task_tcb_t *volatile current;                  // Innermost running handler
+#endif
+#endif
+#if (TASK_CFG_IDLE != 0)
+    task_idle_hook_t idle_hook;                    // Called when nothing is pending
+    task_job_t *jobs;                              // Background jobs, run round robin
+    task_job_t *job_next;                          // Job that gets the next slice
+    uint32_t idle_from;                            // Tick the idle pass started on
+    uint32_t idle_next;                            // Ticks from idle_from to the next release
+#endif
+#if (TASK_CFG_LOAD != 0)
+    task_load_t load;                              // Load window, handler time summed on read
+    uint32_t load_last;                            // Cycle stamp up to which total_cycles runs
+#endif
+    task_tcb_t rate[TASK_COUNT];                   // Built-in fixed frequency tasks
 } task_scheduler_t;
 
+#if (TASK_CFG_ANALYSIS != 0)
+/**
+ * @brief
+ * One task as seen by the schedulability analysis, in TASK_PORT_CYCLES() units.
+ */
+typedef struct
+{
+    const task_tcb_t *task;                        // Task, or the task_admit() candidate
+    uint64_t cost;                                 // Execution time of one release, chain stages included
+    uint64_t gap;                                  // Shortest distance between two releases
+    uint16_t index;                                // Order within a ready level
+    uint8_t level;                                 // Rate monotonic level, 0 in other dispatch modes
+} task_analysis_item_t;
+#endif
+
 /* Private Variables ---------------------------------------------------------*/
 
 // Configuration Table (Kept separate as it is CONSTANT data, saves RAM)
-static const uint16_t task_ticks[TASK_COUNT] =
+static const uint32_t task_ticks[TASK_COUNT] =
 {
     [TASK_1HZ]   = TICK_1HZ,
     [TASK_2HZ]   = TICK_2HZ,
@@ -70,70 +228,3686 @@ static const uint16_t task_ticks[TASK_COUNT] =
     [TASK_200HZ] = TICK_200HZ
 };
 
-// The Singleton Scheduler Instance
+// One Scheduler Instance per Core, each padded to whole cache lines with TASK_CFG_CACHE_LINE
 // Initialized to 0 automatically by static rules, but explicit {0} is good practice.
-static task_scheduler_t scheduler = {0};
+static TASK_PORT_FAST_DATA task_scheduler_t schedulers[TASK_CFG_CORES] = {{0}};
 
-/* Function Definitions ------------------------------------------------------*/
+/* Private Functions ---------------------------------------------------------*/
 
 /**
  * @brief
- * Increment the tick count and set the flags for tasks based on their frequencies.
+ * Scheduler instance of the calling core.
+ */
+static inline task_scheduler_t *task_self(void)
+{
+#if (TASK_CFG_CORES > 1)
+    return &schedulers[TASK_PORT_CORE_ID()];
+#else
+    return &schedulers[0];
+#endif
+}
+
+/**
+ * @brief
+ * Scheduler instance a task is registered with.
  */
-void task_tick(void)
+static inline task_scheduler_t *task_owner(const task_tcb_t *task)
 {
-    scheduler.tick_count++;
+#if (TASK_CFG_CORES > 1)
+    return &schedulers[task->core];
+#else
+    (void)task;
+    return &schedulers[0];
+#endif
+}
 
-    for (uint8_t i = 0; i < TASK_COUNT; i++)
+#if (TASK_CFG_READY_MASK != 0)
+/**
+ * @brief
+ * Map a ready mask slot back to its task control block.
+ */
+static TASK_PORT_FAST_CODE task_tcb_t *task_from_index(task_scheduler_t *s, uint16_t index)
+{
+    if (index < TASK_COUNT)
     {
-        // Check if it's time to run this task
-        if (scheduler.tick_count % task_ticks[i] == 0)
+        return &s->rate[index];
+    }
+
+    return &s->pool[index - TASK_COUNT];
+}
+
+/**
+ * @brief
+ * Ready mask word holding the bit of a task.
+ */
+static inline TASK_ATOMIC_U32 *task_ready_word(task_scheduler_t *s, const task_tcb_t *task)
+{
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+    return &s->ready[task->priority][task->index >> 5];
+#else
+    return &s->ready[0][task->index >> 5];
+#endif
+}
+#endif
+
+#if (TASK_CFG_ENGINE == TASK_ENGINE_HEAP)
+/**
+ * @brief
+ * Wrap-safe "release of a is before release of b".
+ */
+static inline uint8_t task_heap_before(const task_tcb_t *a, const task_tcb_t *b)
+{
+    return (int32_t)(a->due - b->due) < 0;
+}
+
+/**
+ * @brief
+ * Store a task at a heap position and keep its back reference in sync.
+ */
+static inline void task_heap_place(task_scheduler_t *s, task_tcb_t *task, uint16_t slot)
+{
+    s->heap[slot] = task;
+    task->heap_slot = slot;
+}
+
+/**
+ * @brief
+ * Move the task at `slot` towards the root until its parent is due no later.
+ */
+static TASK_PORT_FAST_CODE void task_heap_up(task_scheduler_t *s, uint16_t slot)
+{
+    task_tcb_t *task = s->heap[slot];
+
+    while (slot > 0U)
+    {
+        uint16_t parent = (uint16_t)((slot - 1U) / 2U);
+
+        if (!task_heap_before(task, s->heap[parent]))
         {
-            if (scheduler.flags[i] == 1)
-            {
-                // Previous flag was not cleared, overflow occurred
-                scheduler.overflow_count[i]++;
-            }
+            break;
+        }
+
+        task_heap_place(s, s->heap[parent], slot);
+        slot = parent;
+    }
+
+    task_heap_place(s, task, slot);
+}
+
+/**
+ * @brief
+ * Move the task at `slot` towards the leaves until both children are due no earlier.
+ */
+static TASK_PORT_FAST_CODE void task_heap_down(task_scheduler_t *s, uint16_t slot)
+{
+    task_tcb_t *task = s->heap[slot];
+
+    for (;;)
+    {
+        uint16_t child = (uint16_t)(2U * slot + 1U);
 
-            scheduler.flags[i] = 1;
+        if (child >= s->heap_count)
+        {
+            break;
+        }
+
+        if (((child + 1U) < s->heap_count) &&
+            task_heap_before(s->heap[child + 1U], s->heap[child]))
+        {
+            child++;
         }
+
+        if (!task_heap_before(s->heap[child], task))
+        {
+            break;
+        }
+
+        task_heap_place(s, s->heap[child], slot);
+        slot = child;
     }
 
-    if (scheduler.tick_count >= TICK_1HZ)
+    task_heap_place(s, task, slot);
+}
+
+/**
+ * @brief
+ * Take a task out of the heap from any position.
+ */
+static void task_heap_remove(task_scheduler_t *s, task_tcb_t *task)
+{
+    uint16_t slot = task->heap_slot;
+    task_tcb_t *last = s->heap[--s->heap_count];
+
+    if (last == task)
     {
-        scheduler.tick_count = 0; // Reset every 1 second
+        return;
     }
+
+    task_heap_place(s, last, slot);
+    task_heap_up(s, slot);
+    task_heap_down(s, last->heap_slot);
 }
+#endif
 
 /**
  * @brief
- * Check if any task flags are set. If a flag is set, reset it and call the handler.
+ * Append an event to the trace ring, overwriting the oldest one when it is full.
+ * The ring is the one of the core recording the event, whose interrupts the critical
+ * section masks: a task stolen from `s` is traced by the core that runs it, with `s`
+ * kept as the owner of the task index.
  */
-void task_handler(void)
+static inline void task_trace(task_scheduler_t *s, uint8_t type, const task_tcb_t *task)
 {
-    for (uint8_t i = 0; i < TASK_COUNT; i++)
+#if (TASK_CFG_TRACE != 0)
+    task_scheduler_t *self = task_self();
+
+    if (self->trace == NULL)
     {
-        if (scheduler.flags[i])
-        {
-            // Clear flag first to allow re-triggering if handler takes too long (optional safety)
-            scheduler.flags[i] = 0;
+        return;
+    }
 
-            if (scheduler.handler_cb[i] != NULL)
-            {
-                scheduler.handler_cb[i]();
-            }
-        }
+    TASK_ENTER_CRITICAL();
+
+    // Stamped inside the section, so the ring order is also the stamp order
+    task_trace_event_t *event = &self->trace[self->trace_head & self->trace_mask];
+
+    event->time = TASK_PORT_CYCLES();
+    event->task = task->index;
+    event->type = (uint8_t)(type | ((uint32_t)(s - schedulers) << TASK_TRACE_OWNER_SHIFT));
+    event->core = (uint8_t)(self - schedulers);
+    self->trace_head++;
+
+    TASK_EXIT_CRITICAL();
+#else
+    (void)s;
+    (void)type;
+    (void)task;
+#endif
+}
+
+#if (TASK_CFG_SLICES != 0)
+/**
+ * @brief
+ * Slices of a sliced task placed before offset `r` (0..period) of its period. Slice k
+ * sits at floor(k * period / slices), so this is ceil(r * slices / period).
+ */
+static inline uint32_t task_slices_below(const task_tcb_t *task, uint32_t r)
+{
+    return (uint32_t)((((uint64_t)r * task->slices) + task->period - 1U) / task->period);
+}
+
+/**
+ * @brief
+ * Offset of slice k in the period of a sliced task.
+ */
+static inline uint32_t task_slice_offset(const task_tcb_t *task, uint32_t k)
+{
+    return (uint32_t)(((uint64_t)k * task->period) / task->slices);
+}
+#endif
+
+/**
+ * @brief
+ * Ticks from tick `tick` to the first release after it.
+ */
+static inline uint32_t task_release_after(const task_tcb_t *task, uint32_t tick)
+{
+    uint32_t offset = (tick + task->period - task->phase) % task->period;
+
+#if (TASK_CFG_SLICES != 0)
+    if (task->slices != 0U)
+    {
+        uint32_t k = task_slices_below(task, offset + 1U);
+
+        return ((k < task->slices) ? task_slice_offset(task, k) : task->period) - offset;
     }
+#endif
+
+    return task->period - offset;
 }
 
 /**
  * @brief
- * Register a task handler for a specific task type.
+ * Returns 1 if a task is released on tick `tick`.
  */
-void task_register_handler(task_type_t task_type, task_handler_cb_t handler)
+static inline uint8_t task_due_on(const task_tcb_t *task, uint32_t tick)
+{
+#if (TASK_CFG_SLICES != 0)
+    if (task->slices != 0U)
+    {
+        return task_release_after(task, tick - 1U) == 1U;
+    }
+#endif
+
+    return ((tick + task->period - task->phase) % task->period) == 0U;
+}
+
+#if (TASK_CFG_SLICES != 0)
+/**
+ * @brief
+ * Index of the slice released on tick `tick`, a release tick of the sliced task.
+ */
+static inline uint16_t task_slice_at(const task_tcb_t *task, uint32_t tick)
+{
+    return (uint16_t)task_slices_below(task, (tick + task->period - task->phase) % task->period);
+}
+
+/**
+ * @brief
+ * Releases of a sliced task on the ticks after `tick` up to `tick + span`.
+ */
+static uint32_t task_slices_within(const task_tcb_t *task, uint32_t tick, uint32_t span)
+{
+    uint32_t offset = (tick + task->period - task->phase) % task->period;
+    uint32_t end = offset + (span % task->period) + 1U;
+    uint32_t count = (span / task->period) * task->slices;
+
+    // The partial period may wrap into the next one
+    if (end > task->period)
+    {
+        count += task->slices + task_slices_below(task, end - task->period);
+    }
+    else
+    {
+        count += task_slices_below(task, end);
+    }
+
+    return count - task_slices_below(task, offset + 1U);
+}
+#endif
+
+/**
+ * @brief
+ * Count `count` lost releases of a task.
+ */
+static inline void task_overflow(task_scheduler_t *s, task_tcb_t *task, uint32_t count)
+{
+    task->overflow_count += count;
+#if (TASK_CFG_SHED != 0)
+    s->shed_overflows += count;
+#endif
+    task_trace(s, TASK_TRACE_OVERFLOW, task);
+}
+
+#if (TASK_CFG_SHED != 0)
+/**
+ * @brief
+ * Count the nominal releases a halved rate skips in the `span` ticks from a release
+ * to the next one, besides the `inner` releases made in between. All of them lie on
+ * the nominal grid, since shedding keeps the phase. Counted when the gap starts;
+ * task_get_shed_count() leaves out the ones still ahead. Slices are not on that grid:
+ * a sliced task only counts its releases dropped while suspended. A task stopped by
+ * task_suspend() loses its releases to that, not to shedding.
+ */
+static inline void task_shed_skip(task_tcb_t *task, uint32_t span, uint32_t inner)
+{
+#if (TASK_CFG_SLICES != 0)
+    if (task->slices != 0U)
+    {
+        return;
+    }
+#endif
+
+    if (task->suspended)
+    {
+        return;
+    }
+
+    uint32_t slots = span / task->nominal;
+
+    if (slots > (inner + 1U))
+    {
+        task->shed_count += slots - inner - 1U;
+    }
+}
+#endif
+
+/**
+ * @brief
+ * Mark a task as released on this tick. In ready mask mode the bit is collected
+ * in `released` and published by task_tick() with one atomic operation per word.
+ * Rate monotonic dispatch publishes the bit right away and collects the level instead.
+ */
+static inline void task_release(task_scheduler_t *s, task_tcb_t *task, uint32_t *released, uint32_t now)
+{
+#if (TASK_CFG_RETUNE != 0)
+    if (task->suspended)
+    {
+        return;
+    }
+#endif
+#if (TASK_CFG_SHED != 0)
+    if (task->shed == TASK_SHED_SUSPEND)
+    {
+        task->shed_count++;
+        return;
+    }
+#endif
+
+#if (TASK_CFG_OVERRUN != 0)
+    if ((task->overrun == TASK_OVERRUN_SKIP) && task->busy)
+    {
+        // Released while its handler still runs: drop it, the next release is on time again
+        task_overflow(s, task, 1);
+        return;
+    }
+
+    task->releases++;
+#endif
+
+    task_trace(s, TASK_TRACE_RELEASE, task);
+
+#if (TASK_CFG_SLICES != 0)
+    if (task->slices != 0U)
+    {
+        task->slice = task_slice_at(task, s->tick_count);
+    }
+#endif
+
+#if (TASK_CFG_STATS != 0)
+    task->release_cycles = now;
+#else
+    (void)now;
+#endif
+
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_EDF)
+    task->deadline = s->tick_count + task->period;
+#endif
+
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+    if ((TASK_ATOMIC_FETCH_OR(task_ready_word(s, task), TASK_READY_BIT(task->index)) & TASK_READY_BIT(task->index)) != 0U)
+    {
+        // Bit was still set, the previous release had not been taken
+        task_overflow(s, task, 1);
+    }
+
+    released[0] |= (1UL << task->priority);
+#elif (TASK_CFG_READY_MASK != 0)
+    (void)s;
+    released[task->index >> 5] |= TASK_READY_BIT(task->index);
+#else
+    (void)s;
+    (void)released;
+
+    if (task->flag == 1)
+    {
+        // Previous flag was not cleared, overflow occurred
+        task_overflow(s, task, 1);
+    }
+
+    task->flag = 1;
+#endif
+}
+
+#if (TASK_CFG_STATS != 0)
+/**
+ * @brief
+ * Histogram bucket of a cycle count (log2 scale, see task_stats_t).
+ */
+static inline uint8_t task_stats_bucket(uint32_t cycles)
+{
+    cycles >>= TASK_CFG_STATS_HIST_SHIFT;
+
+    if (cycles == 0U)
+    {
+        return 0;
+    }
+
+    uint8_t bucket = (uint8_t)(32U - TASK_CLZ(cycles));
+
+    return (bucket < TASK_CFG_STATS_BUCKETS) ? bucket : (uint8_t)(TASK_CFG_STATS_BUCKETS - 1U);
+}
+
+/**
+ * @brief
+ * Fold one handler run into the statistics of its task.
+ */
+static TASK_PORT_FAST_CODE void task_stats_record(task_stats_t *stats, uint32_t latency, uint32_t exec)
+{
+    if ((stats->runs == 0U) || (exec < stats->exec_min))
+    {
+        stats->exec_min = exec;
+    }
+    if ((stats->runs == 0U) || (latency < stats->latency_min))
+    {
+        stats->latency_min = latency;
+    }
+    if (exec > stats->exec_max)
+    {
+        stats->exec_max = exec;
+    }
+    if (latency > stats->latency_max)
+    {
+        stats->latency_max = latency;
+    }
+
+    stats->exec_sum += exec;
+    stats->latency_sum += latency;
+    stats->exec_hist[task_stats_bucket(exec)]++;
+    stats->latency_hist[task_stats_bucket(latency)]++;
+    stats->runs++;
+}
+#endif
+
+/**
+ * @brief
+ * Set the handler of a task; with `with_ctx` it is a task_handler_ctx_cb_t called with `ctx`.
+ */
+static inline void task_bind(task_tcb_t *task, task_handler_cb_t handler, void *ctx, uint8_t with_ctx)
 {
-    if (task_type < TASK_COUNT)
+    task->handler = handler;
+#if (TASK_CFG_HANDLER_CTX != 0)
+    task->ctx = ctx;
+    task->with_ctx = with_ctx;
+#else
+    (void)ctx;
+    (void)with_ctx;
+#endif
+}
+
+/**
+ * @brief
+ * Call the handler of a task, with its context for a context handler.
+ */
+static inline void task_call(const task_tcb_t *task)
+{
+#if (TASK_CFG_SLICES != 0)
+    if (task->slices != 0U)
+    {
+        ((task_slice_cb_t)task->handler)(task->slice);
+        return;
+    }
+#endif
+#if (TASK_CFG_HANDLER_CTX != 0)
+    if (task->with_ctx)
     {
-        scheduler.handler_cb[task_type] = handler;
+        ((task_handler_ctx_cb_t)task->handler)(task->ctx);
+        return;
     }
+#endif
+    task->handler();
+}
+
+/**
+ * @brief
+ * Call the handler of a released task, timing it when statistics are enabled
+ * and exposing it to the budget check of task_tick() while it runs.
+ */
+static inline void task_exec(task_scheduler_t *s, task_tcb_t *task)
+{
+#if (TASK_CFG_BUDGET != 0)
+    task->run_start = s->tick_count;
+    task->budget_done = 0;
+#if (TASK_BUSY_GUARD == 0)
+    task->outer = s->current;
+    s->current = task;
+#endif
+#else
+    (void)s;
+#endif
+
+    task_trace(s, TASK_TRACE_START, task);
+
+#if (TASK_CFG_STATS != 0) || (TASK_CFG_LOAD != 0)
+    uint32_t start = TASK_PORT_CYCLES();
+
+    task_call(task);
+
+    uint32_t exec = TASK_PORT_CYCLES() - start;
+
+#if (TASK_CFG_STATS != 0)
+    task_stats_record(&task->stats, start - task->release_cycles, exec);
+#endif
+#if (TASK_CFG_LOAD != 0)
+    task->busy_cycles += exec;
+#endif
+#else
+    task_call(task);
+#endif
+
+    task_trace(s, TASK_TRACE_END, task);
+
+#if (TASK_CFG_BUDGET != 0)
+#if (TASK_BUSY_GUARD == 0)
+    s->current = task->outer;
+#endif
+    task->budget_done = 1;
+#endif
+}
+
+#if (TASK_CFG_BUDGET != 0)
+/**
+ * @brief
+ * Report a running handler once when it has used up its budget. Called from task_tick().
+ */
+static TASK_PORT_FAST_CODE void task_budget_check(task_scheduler_t *s, task_tcb_t *task)
+{
+    uint32_t elapsed = s->tick_count - task->run_start;
+
+    if ((task->budget_done == 0U) && (task->budget != 0U) && (elapsed >= task->budget))
+    {
+        task->budget_done = 1;
+        task->budget_overruns++;
+
+        if (s->budget_hook != NULL)
+        {
+            s->budget_hook(task, elapsed);
+        }
+    }
+}
+
+/**
+ * @brief
+ * Check every handler in progress: the running bits when several threads dispatch,
+ * otherwise the innermost handler and the ones it preempted.
+ */
+static TASK_PORT_FAST_CODE void task_budget_scan(task_scheduler_t *s)
+{
+#if (TASK_BUSY_GUARD != 0)
+    for (uint16_t w = 0; w < TASK_READY_WORDS; w++)
+    {
+        for (uint32_t running = TASK_ATOMIC_LOAD(&s->running[w]); running != 0U; running &= running - 1U)
+        {
+            task_budget_check(s, task_from_index(s, (uint16_t)((w << 5) + TASK_CTZ(running))));
+        }
+    }
+#else
+    for (task_tcb_t *task = s->current; task != NULL; task = task->outer)
+    {
+        task_budget_check(s, task);
+    }
+#endif
+}
+#endif
+
+#if (TASK_CFG_READY_MASK != 0)
+/**
+ * @brief
+ * Mark a task pending outside of task_tick() and signal its ready level.
+ */
+static inline void task_pend(task_scheduler_t *s, task_tcb_t *task)
+{
+    (void)TASK_ATOMIC_FETCH_OR(task_ready_word(s, task), TASK_READY_BIT(task->index));
+
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+#if (TASK_CFG_PREEMPT_LEVELS > 0)
+    if (task->priority < TASK_CFG_PREEMPT_LEVELS)
+    {
+        TASK_PORT_PEND(task->priority);
+        return;
+    }
+#endif
+    (void)TASK_ATOMIC_FETCH_OR(&s->ready_levels, 1UL << task->priority);
+#endif
+}
+#endif
+
+#if (TASK_CFG_CHAINS != 0)
+/**
+ * @brief
+ * Count a finished predecessor of a stage. Returns 1 when it was the last one
+ * of this pass, and rearms the count for the next pass.
+ */
+static inline uint8_t task_chain_done(task_tcb_t *stage)
+{
+    uint8_t ready = 0;
+
+    TASK_ENTER_CRITICAL();
+
+    if (--stage->waiting == 0U)
+    {
+        stage->waiting = stage->deps;
+        ready = 1;
+    }
+
+    TASK_EXIT_CRITICAL();
+
+    return ready;
+}
+
+/**
+ * @brief
+ * Run the stages following a finished task through a local FIFO: each stage runs
+ * once all of its predecessors have, and the stack depth does not grow with the
+ * chain length. With several host workers one ready stage continues here and the
+ * others are pended for idle workers, so independent branches run in parallel.
+ */
+static void task_chain_run(task_scheduler_t *s, task_tcb_t *task)
+{
+    task_tcb_t *head = NULL;
+    task_tcb_t **tail = &head;
+
+    while (task != NULL)
+    {
+#if (TASK_CFG_HOST_WORKERS > 1)
+        uint8_t handed = 0;
+#endif
+
+        for (task_edge_t *edge = task->succ; edge != NULL; edge = edge->next)
+        {
+            task_tcb_t *stage = edge->to;
+
+            if (task_chain_done(stage) == 0U)
+            {
+                continue;
+            }
+
+            task_trace(s, TASK_TRACE_RELEASE, stage);
+#if (TASK_CFG_STATS != 0)
+            stage->release_cycles = TASK_PORT_CYCLES();
+#endif
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_EDF)
+            stage->deadline = task->deadline;
+#endif
+
+#if (TASK_CFG_HOST_WORKERS > 1)
+            if (head != NULL)
+            {
+                task_pend(task_owner(stage), stage);
+                handed = 1;
+                continue;
+            }
+#endif
+
+            stage->chain_next = NULL;
+            *tail = stage;
+            tail = &stage->chain_next;
+        }
+
+#if (TASK_CFG_HOST_WORKERS > 1)
+        if (handed)
+        {
+            task_host_notify();
+        }
+#endif
+
+        task = head;
+
+        if (task != NULL)
+        {
+            head = task->chain_next;
+
+            if (head == NULL)
+            {
+                tail = &head;
+            }
+
+            task_exec(s, task);
+        }
+    }
+}
+#endif
+
+/**
+ * @brief
+ * Run a released task, followed by the chain stages it completes.
+ */
+static inline void task_run(task_scheduler_t *s, task_tcb_t *task)
+{
+    task_exec(s, task);
+
+#if (TASK_CFG_CHAINS != 0)
+    if (task->succ != NULL)
+    {
+        task_chain_run(s, task);
+    }
+#endif
+}
+
+#if (TASK_CFG_OVERRUN != 0)
+/**
+ * @brief
+ * Run a claimed task under its overrun policy. A catch-up task runs its backlog,
+ * at most TASK_CFG_CATCHUP_BURST releases, and stays pending for the rest.
+ */
+static TASK_PORT_FAST_CODE void task_run_overrun(task_scheduler_t *s, task_tcb_t *task)
+{
+    task->busy = 1;
+
+    if (task->overrun != TASK_OVERRUN_CATCHUP)
+    {
+        task->served = task->releases;
+        task_run(s, task);
+    }
+    else
+    {
+        for (uint16_t n = TASK_CFG_CATCHUP_BURST; (n != 0U) && (task->served != task->releases); n--)
+        {
+            task->served++;
+            task_run(s, task);
+        }
+
+        if (task->served != task->releases)
+        {
+            // Rest of the backlog waits for the next dispatch, behind the other pending tasks
+#if (TASK_CFG_READY_MASK != 0)
+            task_pend(s, task);
+#else
+            task->flag = 1;
+#endif
+        }
+    }
+
+    task->busy = 0;
+#if (TASK_CFG_READY_MASK == 0)
+    (void)s;
+#endif
+}
+#endif
+
+/**
+ * @brief
+ * Run a claimed task. With several cores or host workers, a task can be claimed
+ * again while its handler still executes elsewhere; that release is handed back
+ * to the owner instead of running the handler twice at once.
+ * Returns 1 if the handler ran.
+ */
+static TASK_PORT_FAST_CODE uint8_t task_dispatch(task_scheduler_t *s, task_tcb_t *task)
+{
+    if (task->handler == NULL)
+    {
+        return 0;
+    }
+
+#if (TASK_BUSY_GUARD != 0)
+    uint32_t bit = TASK_READY_BIT(task->index);
+    TASK_ATOMIC_U32 *running = &s->running[task->index >> 5];
+
+    if ((TASK_ATOMIC_FETCH_OR(running, bit) & bit) != 0U)
+    {
+        task_pend(s, task);
+        return 0;
+    }
+
+#if (TASK_CFG_OVERRUN != 0)
+    task_run_overrun(s, task);
+#else
+    task_run(s, task);
+#endif
+
+    (void)TASK_ATOMIC_FETCH_AND(running, ~bit);
+#elif (TASK_CFG_OVERRUN != 0)
+    task_run_overrun(s, task);
+#else
+    (void)s;
+    task_run(s, task);
+#endif
+
+    return 1;
+}
+
+/**
+ * @brief
+ * Ticks from now until the first tick t > tick_count with t % period == phase.
+ */
+static inline uint32_t task_first_release(task_scheduler_t *s, const task_tcb_t *task)
+{
+    return task_release_after(task, s->tick_count);
+}
+
+#if (TASK_CFG_RETUNE != 0)
+/**
+ * @brief
+ * Take over the period of the latest task_set_period() call. The phase is kept,
+ * reduced modulo the new period, so releases stay on ticks t % period == phase.
+ */
+static inline void task_retune(task_tcb_t *task)
+{
+    uint32_t period = task->period_req;
+
+    task->period = period;
+    task->phase %= period;
+}
+#endif
+
+/**
+ * @brief
+ * Ticks from a release on the current tick to the next one, with a pending period
+ * change taking effect now. Called by task_tick() on each release.
+ */
+static inline uint32_t task_reload(task_scheduler_t *s, task_tcb_t *task)
+{
+    uint32_t next = task->period;
+
+#if (TASK_CFG_RETUNE != 0)
+    if (task->period_req != task->period)
+    {
+        task_retune(task);
+        next = task_first_release(s, task);
+    }
+#endif
+#if (TASK_CFG_SLICES != 0)
+    if (task->slices != 0U)
+    {
+        next = task_first_release(s, task);
+    }
+#endif
+#if (TASK_CFG_SHED != 0)
+    task_shed_skip(task, next, 0);
+#endif
+
+    (void)s;
+
+    return next;
+}
+
+/**
+ * @brief
+ * Arm a task and insert it into the active list, keeping the list sorted by index
+ * so that dispatch order matches the ready mask order. Called with interrupts masked.
+ */
+static void task_link(task_scheduler_t *s, task_tcb_t *task)
+{
+    task_tcb_t **link = &s->active;
+
+#if (TASK_CFG_ENGINE == TASK_ENGINE_HEAP)
+    task->due = s->tick_count + task_first_release(s, task);
+    s->heap[s->heap_count] = task;
+    task_heap_up(s, s->heap_count++);
+#else
+    task->countdown = task_first_release(s, task);
+#endif
+    task->flag = 0;
+#if (TASK_CFG_RETUNE != 0)
+    task->period_req = task->period;
+    task->suspended = 0;
+#endif
+#if (TASK_CFG_SHED != 0)
+    task->nominal = task->period;
+    task->shed_count = 0;
+    task->criticality = TASK_CRIT_HIGH;
+    task->shed = TASK_SHED_NONE;
+#endif
+#if (TASK_CFG_CORES > 1)
+    task->core = (uint8_t)(s - schedulers);
+#endif
+#if (TASK_CFG_BUDGET != 0)
+    task->budget_done = 1;
+#endif
+
+    while ((*link != NULL) && ((*link)->index < task->index))
+    {
+        link = &(*link)->next;
+    }
+
+    task->next = *link;
+    *link = task;
+    s->active_count++;
+}
+
+/**
+ * @brief
+ * Remove a task from the active list and drop any pending release. Called with interrupts masked.
+ */
+static void task_unlink(task_scheduler_t *s, task_tcb_t *task)
+{
+    task_tcb_t **link = &s->active;
+
+    while ((*link != NULL) && (*link != task))
+    {
+        link = &(*link)->next;
+    }
+
+    if (*link == task)
+    {
+        *link = task->next;
+        s->active_count--;
+#if (TASK_CFG_ENGINE == TASK_ENGINE_HEAP)
+        task_heap_remove(s, task);
+#endif
+    }
+
+    task->flag = 0;
+#if (TASK_CFG_READY_MASK != 0)
+    (void)TASK_ATOMIC_FETCH_AND(task_ready_word(s, task), ~TASK_READY_BIT(task->index));
+#endif
+#if (TASK_CFG_CORES > 1)
+    (void)TASK_ATOMIC_FETCH_AND(&s->stealable[task->index >> 5], ~TASK_READY_BIT(task->index));
+#endif
+}
+
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+/**
+ * @brief
+ * Rate monotonic level of a period: floor(log2(period)), so shorter periods are more urgent.
+ */
+static uint8_t task_rm_priority(uint32_t period)
+{
+    uint8_t level = (uint8_t)(31U - TASK_CLZ(period));
+
+    return (level < TASK_CFG_PRIORITY_LEVELS) ? level : (uint8_t)(TASK_CFG_PRIORITY_LEVELS - 1U);
+}
+#endif
+
+#if (TASK_CFG_READY_MASK != 0)
+#if (TASK_CFG_DISPATCH != TASK_DISPATCH_EDF)
+/**
+ * @brief
+ * Atomically take the lowest indexed pending task of one ready level, NULL if none.
+ * Safe against task_tick() and against other consumers.
+ */
+static TASK_PORT_FAST_CODE task_tcb_t *task_claim_level(task_scheduler_t *s, uint8_t level)
+{
+    for (uint16_t w = 0; w < TASK_READY_WORDS; w++)
+    {
+        uint32_t ready = TASK_ATOMIC_LOAD(&s->ready[level][w]);
+
+        while (ready != 0U)
+        {
+            uint32_t bit = ready & (0U - ready);
+            uint32_t prev = TASK_ATOMIC_FETCH_AND(&s->ready[level][w], ~bit);
+
+            if ((prev & bit) != 0U)
+            {
+                return task_from_index(s, (uint16_t)((w << 5) + TASK_CTZ(bit)));
+            }
+
+            // Taken by someone else in the meantime, look again
+            ready = prev & ~bit;
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_EDF)
+/**
+ * @brief
+ * Atomically take the pending task with the earliest deadline, NULL if none.
+ */
+static TASK_PORT_FAST_CODE task_tcb_t *task_claim_edf(task_scheduler_t *s)
+{
+    for (;;)
+    {
+        task_tcb_t *best = NULL;
+
+        for (uint16_t w = 0; w < TASK_READY_WORDS; w++)
+        {
+            uint32_t ready = TASK_ATOMIC_LOAD(&s->ready[0][w]);
+
+            while (ready != 0U)
+            {
+                task_tcb_t *task = task_from_index(s, (uint16_t)((w << 5) + TASK_CTZ(ready)));
+                ready &= ready - 1U;
+
+                // Strictly earlier only, equal deadlines keep index order
+                if ((best == NULL) || ((int32_t)(task->deadline - best->deadline) < 0))
+                {
+                    best = task;
+                }
+            }
+        }
+
+        if (best == NULL)
+        {
+            return NULL;
+        }
+
+        if ((TASK_ATOMIC_FETCH_AND(task_ready_word(s, best), ~TASK_READY_BIT(best->index)) &
+             TASK_READY_BIT(best->index)) != 0U)
+        {
+            return best;
+        }
+    }
+}
+#endif
+
+/**
+ * @brief
+ * Atomically take the most urgent pending task under the configured dispatch order.
+ */
+static TASK_PORT_FAST_CODE task_tcb_t *task_claim(task_scheduler_t *s)
+{
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+    uint32_t levels;
+
+    while ((levels = TASK_ATOMIC_LOAD(&s->ready_levels)) != 0U)
+    {
+        uint8_t level = TASK_CTZ(levels);
+        task_tcb_t *task = task_claim_level(s, level);
+
+        if (task != NULL)
+        {
+            return task;
+        }
+
+        // Level drained: drop its summary bit, and restore it if a release raced in
+        (void)TASK_ATOMIC_FETCH_AND(&s->ready_levels, ~(1UL << level));
+
+        for (uint16_t w = 0; w < TASK_READY_WORDS; w++)
+        {
+            if (TASK_ATOMIC_LOAD(&s->ready[level][w]) != 0U)
+            {
+                (void)TASK_ATOMIC_FETCH_OR(&s->ready_levels, 1UL << level);
+                break;
+            }
+        }
+    }
+
+    return NULL;
+#elif (TASK_CFG_DISPATCH == TASK_DISPATCH_EDF)
+    return task_claim_edf(s);
+#else
+    return task_claim_level(s, 0);
+#endif
+}
+#endif
+
+/**
+ * @brief
+ * Publish the releases collected by one task_tick() / task_tick_n() call.
+ */
+static inline void task_publish(task_scheduler_t *s, uint32_t *released)
+{
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+    if ((released[0] & ~TASK_PREEMPT_MASK) != 0U)
+    {
+        (void)TASK_ATOMIC_FETCH_OR(&s->ready_levels, released[0] & ~TASK_PREEMPT_MASK);
+    }
+#if (TASK_CFG_PREEMPT_LEVELS > 0)
+    // Preemptive levels bypass the level summary and go straight to their interrupt
+    for (uint32_t pend = released[0] & TASK_PREEMPT_MASK; pend != 0U; pend &= pend - 1U)
+    {
+        TASK_PORT_PEND(TASK_CTZ(pend));
+    }
+#endif
+#elif (TASK_CFG_READY_MASK != 0)
+    for (uint16_t w = 0; w < TASK_READY_WORDS; w++)
+    {
+        if (released[w] == 0U)
+        {
+            continue;
+        }
+
+        // Bits that were still set had not been taken by task_handler(), overflow occurred
+        uint32_t missed = TASK_ATOMIC_FETCH_OR(&s->ready[0][w], released[w]) & released[w];
+
+        while (missed != 0U)
+        {
+            task_overflow(s, task_from_index(s, (uint16_t)((w << 5) + TASK_CTZ(missed))), 1);
+            missed &= missed - 1U;
+        }
+    }
+#else
+    (void)s;
+    (void)released;
+#endif
+}
+
+/**
+ * @brief
+ * Apply the releases of a task in the `ticks` ticks after tick `from`, the first one
+ * `first` ticks after it (1..period), with the accounting of as many task_tick() calls.
+ * Returns the offset from `from` of its next release after the step.
+ */
+static uint32_t task_release_n(task_scheduler_t *s, task_tcb_t *task, uint32_t *released, uint32_t now,
+                               uint32_t from, uint32_t first, uint32_t ticks)
+{
+    if (first > ticks)
+    {
+        return first;
+    }
+
+    uint32_t next = first + task->period;
+
+#if (TASK_CFG_RETUNE != 0)
+    if (task->period_req != task->period)
+    {
+        // The change takes effect on the first release, as task_tick() would apply it
+        task_retune(task);
+        next = first + task_release_after(task, from + first);
+    }
+#endif
+
+    uint32_t extra = 0;
+    uint32_t last = first;
+
+#if (TASK_CFG_SLICES != 0)
+    if (task->slices != 0U)
+    {
+        // Uneven spacing: count the slices between the first release and the end of the step
+        next = first + task_release_after(task, from + first);
+
+        if (next <= ticks)
+        {
+            // The last one is the latest slice offset at or before the end of the step
+            uint32_t offset = (from + ticks + task->period - task->phase) % task->period;
+            uint32_t k = task_slices_below(task, offset + 1U) - 1U;
+
+            extra = task_slices_within(task, from + first, ticks - first);
+            last = ticks - (offset - task_slice_offset(task, k));
+        }
+
+        next = ticks + task_release_after(task, from + ticks);
+    }
+    else
+#endif
+    if (next <= ticks)
+    {
+        extra = 1U + ((ticks - next) / task->period);
+        last = next + ((extra - 1U) * task->period);
+        next = last + task->period;
+    }
+
+#if (TASK_CFG_RETUNE != 0)
+    if (task->suspended)
+    {
+        return next;
+    }
+#endif
+#if (TASK_CFG_SHED != 0)
+    task_shed_skip(task, next - first, extra);
+
+    if (task->shed == TASK_SHED_SUSPEND)
+    {
+        task->shed_count += 1U + extra;
+        return next;
+    }
+#endif
+
+    // Releases after the first find it still pending: each one is an overflow
+#if (TASK_CFG_OVERRUN != 0)
+    if ((task->overrun != TASK_OVERRUN_SKIP) || !task->busy)
+    {
+        task->releases += extra;
+    }
+#endif
+    if (extra != 0U)
+    {
+        task_overflow(s, task, extra);
+    }
+
+    task_release(s, task, released, now);
+
+#if (TASK_CFG_SLICES != 0)
+    if (task->slices != 0U)
+    {
+        task->slice = task_slice_at(task, from + last);
+    }
+#endif
+
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_EDF)
+    task->deadline = from + last + task->period;
+#else
+    (void)from;
+    (void)last;
+#endif
+
+    return next;
+}
+
+#if (TASK_CFG_SHED != 0)
+/**
+ * @brief
+ * Degrade a task as shed level `level` asks. Level 2c + 1 halves the rate of
+ * criticality c, level 2c + 2 suspends it; the period goes through the retune
+ * request, so it changes on the next release with the phase kept.
+ */
+static void task_shed_apply(task_tcb_t *task, uint8_t level)
+{
+    uint8_t first = (uint8_t)(2U * task->criticality);
+    uint8_t shed = TASK_SHED_NONE;
+
+    if (task->criticality < TASK_CRIT_HIGH)
+    {
+        if (level >= (first + 2U))
+        {
+            shed = TASK_SHED_SUSPEND;
+        }
+        else if (level > first)
+        {
+            shed = TASK_SHED_HALF;
+        }
+    }
+
+    if (shed != task->shed)
+    {
+        task->shed = shed;
+        task->period_req = (shed == TASK_SHED_HALF) ? (task->nominal * 2U) : task->nominal;
+    }
+}
+
+/**
+ * @brief
+ * Decide one closed overflow window: one step deeper when it reached
+ * TASK_CFG_SHED_THRESHOLD, one step back after TASK_CFG_SHED_RECOVER windows in a
+ * row without overflow. Returns the new level.
+ */
+static uint8_t task_shed_window(task_scheduler_t *s, uint8_t level, uint32_t overflows)
+{
+    if (overflows >= TASK_CFG_SHED_THRESHOLD)
+    {
+        s->shed_calm = 0;
+
+        if (level < TASK_SHED_LEVELS)
+        {
+            level++;
+        }
+    }
+    else if (overflows != 0U)
+    {
+        s->shed_calm = 0;
+    }
+    else if ((level != 0U) && (++s->shed_calm >= TASK_CFG_SHED_RECOVER))
+    {
+        s->shed_calm = 0;
+        level--;
+    }
+
+    return level;
+}
+
+/**
+ * @brief
+ * Close the overflow windows completed by `ticks` more ticks. `step` of the overflows
+ * counted so far came from these ticks (a task_tick_n() step; 0 for one tick, which
+ * lies in the current window) and are spread evenly over them, so each window of a long
+ * step gets its share. The loop stops once further windows leave the level and the calm
+ * count as they are, after at most TASK_SHED_LEVELS * TASK_CFG_SHED_RECOVER windows, so
+ * the cost does not grow with `ticks`.
+ */
+static void task_shed_check(task_scheduler_t *s, uint32_t ticks, uint32_t step)
+{
+    uint8_t level = s->shed_level;
+    uint32_t head = TASK_CFG_SHED_WINDOW - s->shed_elapsed;    // Ticks left in the current window
+
+    if (ticks < head)
+    {
+        s->shed_elapsed += ticks;
+        return;
+    }
+
+    uint32_t windows = (ticks - head) / TASK_CFG_SHED_WINDOW;  // Whole windows after it
+    uint32_t tail = (ticks - head) % TASK_CFG_SHED_WINDOW;     // Ticks of the next open window
+    uint32_t share = (uint32_t)(((uint64_t)step * TASK_CFG_SHED_WINDOW) / ticks);
+    uint32_t rest = (uint32_t)(((uint64_t)step * tail) / ticks);
+
+    // The rounding stays with the current window, the tail opens the next one
+    uint32_t overflows = s->shed_overflows - rest - (windows * share);
+
+    s->shed_overflows = rest;
+    s->shed_elapsed = tail;
+
+    level = task_shed_window(s, level, overflows);
+
+    for (; windows != 0U; windows--)
+    {
+        uint8_t prev = level;
+        uint8_t calm = s->shed_calm;
+
+        level = task_shed_window(s, level, share);
+
+        if ((level == prev) && (s->shed_calm == calm))
+        {
+            break;
+        }
+    }
+
+    if (level != s->shed_level)
+    {
+        s->shed_level = level;
+
+        for (task_tcb_t *task = s->active; task != NULL; task = task->next)
+        {
+            task_shed_apply(task, level);
+        }
+    }
+}
+#endif
+
+#if (TASK_CFG_EVENTS != 0)
+/**
+ * @brief
+ * Run the events that were queued when the drain started; later posts wait for the
+ * next pass so a busy interrupt cannot keep task_handler() from returning.
+ */
+static TASK_PORT_FAST_CODE void task_queue_drain(task_queue_t *queue)
+{
+    uint16_t tail = queue->tail;
+    uint16_t head = queue->head;
+
+    // Head before the slots it publishes
+    TASK_MEMORY_BARRIER();
+
+    while (tail != head)
+    {
+        task_event_t event = queue->slots[tail & queue->mask];
+
+        // Slot copied before it is handed back to the producer
+        TASK_MEMORY_BARRIER();
+        queue->tail = ++tail;
+
+        event.cb(event.arg);
+    }
+}
+#endif
+
+#if (TASK_CFG_TIMERS != 0)
+/**
+ * @brief
+ * Push a timer at the head of a list.
+ */
+static inline void task_timer_link(task_timer_t **head, task_timer_t *timer)
+{
+    timer->next = *head;
+
+    if (*head != NULL)
+    {
+        (*head)->pprev = &timer->next;
+    }
+
+    *head = timer;
+    timer->pprev = head;
+}
+
+/**
+ * @brief
+ * Take a timer out of whichever list holds it, O(1). Called with interrupts masked.
+ */
+static TASK_PORT_FAST_CODE void task_timer_unlink(task_scheduler_t *s, task_timer_t *timer)
+{
+    if (timer->pprev == NULL)
+    {
+        return;
+    }
+
+    if (s->expired_tail == &timer->next)
+    {
+        s->expired_tail = timer->pprev;
+    }
+
+    *timer->pprev = timer->next;
+
+    if (timer->next != NULL)
+    {
+        timer->next->pprev = timer->pprev;
+    }
+
+    timer->pprev = NULL;
+}
+
+/**
+ * @brief
+ * Move the timers expiring in the last `ticks` ticks to the expired list, visiting
+ * at most one wheel turn of slots, oldest first. One tick orders by expiry; after a
+ * longer step, timers more than one wheel turn apart run in slot order.
+ * Timers of later wheel turns stay in their slot.
+ */
+static TASK_PORT_FAST_CODE void task_timer_expire(task_scheduler_t *s, uint32_t ticks)
+{
+    uint32_t slots = (ticks < TASK_CFG_TIMER_WHEEL) ? ticks : TASK_CFG_TIMER_WHEEL;
+    task_timer_t *next;
+
+    if (s->expired_tail == NULL)
+    {
+        s->expired_tail = &s->expired;
+    }
+
+    for (uint32_t slot = s->tick_count - slots + 1U; slots != 0U; slot++, slots--)
+    {
+        for (task_timer_t *timer = s->wheel[slot & (TASK_CFG_TIMER_WHEEL - 1U)]; timer != NULL; timer = next)
+        {
+            next = timer->next;
+
+            if ((s->tick_count - timer->expires) < ticks)
+            {
+                task_timer_unlink(s, timer);
+
+                timer->next = NULL;
+                timer->pprev = s->expired_tail;
+                *s->expired_tail = timer;
+                s->expired_tail = &timer->next;
+            }
+        }
+    }
+}
+
+/**
+ * @brief
+ * Ticks until the earliest armed timer expires, TASK_TICKS_NEVER if none.
+ * Walks the slots in expiry order and stops as soon as no later slot can be sooner.
+ */
+static uint32_t task_timer_next(task_scheduler_t *s)
+{
+    uint32_t next = TASK_TICKS_NEVER;
+
+    for (uint32_t d = 1; d <= TASK_CFG_TIMER_WHEEL; d++)
+    {
+        for (task_timer_t *timer = s->wheel[(s->tick_count + d) & (TASK_CFG_TIMER_WHEEL - 1U)];
+             timer != NULL; timer = timer->next)
+        {
+            uint32_t left = timer->expires - s->tick_count;
+
+            if (left < next)
+            {
+                next = left;
+            }
+        }
+
+        if (next <= d)
+        {
+            break;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief
+ * Run the callbacks of expired timers, one at a time so a callback may restart
+ * or cancel any timer, including its own.
+ */
+static TASK_PORT_FAST_CODE void task_timer_run(task_scheduler_t *s)
+{
+    while (s->expired != NULL)
+    {
+        task_timer_t *timer;
+
+        TASK_ENTER_CRITICAL();
+
+        timer = s->expired;
+
+        if (timer != NULL)
+        {
+            task_timer_unlink(s, timer);
+        }
+
+        TASK_EXIT_CRITICAL();
+
+        if (timer != NULL)
+        {
+            timer->cb(timer->arg);
+        }
+    }
+}
+#endif
+
+#if (TASK_CFG_IDLE != 0)
+/**
+ * @brief
+ * Idle pass at the end of task_handler(): background job slices round robin until
+ * task_should_yield(), then the idle hook if there still is nothing to do.
+ */
+static void task_idle(task_scheduler_t *s)
+{
+#if (TASK_CFG_LOAD != 0)
+    uint32_t mark = TASK_PORT_CYCLES();
+
+    s->load.total_cycles += mark - s->load_last;
+    s->load_last = mark;
+#endif
+
+    if (task_pending())
+    {
+        return;
+    }
+
+#if (TASK_CFG_HOST_WORKERS > 0)
+    // The host tick thread runs in parallel, not between two instructions: take its lock
+    // for the walk. task_should_yield() below only reads single words, a stale one at most
+    // ends or extends the idle pass by a tick
+    TASK_ENTER_CRITICAL();
+#endif
+
+    s->idle_from = s->tick_count;
+    s->idle_next = task_ticks_to_next();
+
+#if (TASK_CFG_HOST_WORKERS > 0)
+    TASK_EXIT_CRITICAL();
+#endif
+
+    while ((s->jobs != NULL) && !task_should_yield())
+    {
+        task_job_t *job = (s->job_next != NULL) ? s->job_next : s->jobs;
+
+        s->job_next = job->next;
+
+        if (job->cb(job->arg) == 0U)
+        {
+            task_job_cancel(job);
+        }
+    }
+
+#if (TASK_CFG_LOAD != 0)
+    uint32_t now = TASK_PORT_CYCLES();
+
+    s->load.background_cycles += now - mark;
+    mark = now;
+#endif
+
+    if ((s->idle_hook != NULL) && !task_pending())
+    {
+        s->idle_hook();
+    }
+
+#if (TASK_CFG_LOAD != 0)
+    now = TASK_PORT_CYCLES();
+
+    s->load.idle_cycles += now - mark;
+    s->load.total_cycles += now - s->load_last;
+    s->load_last = now;
+#endif
+}
+#endif
+
+/**
+ * @brief
+ * Greatest common divisor of two non-zero periods.
+ */
+static uint32_t task_gcd(uint32_t a, uint32_t b)
+{
+    while (b != 0U)
+    {
+        uint32_t r = a % b;
+        a = b;
+        b = r;
+    }
+
+    return a;
+}
+
+/**
+ * @brief
+ * Strict "a is placed before b" order used by task_stagger(): shorter period first, then index.
+ */
+static inline uint8_t task_stagger_before(const task_tcb_t *a, const task_tcb_t *b)
+{
+    return (a->period < b->period) || ((a->period == b->period) && (a->index < b->index));
+}
+
+/**
+ * @brief
+ * Bind a handler to a built-in frequency task, starting or stopping it as needed.
+ */
+static void task_register(task_scheduler_t *s, task_type_t task_type, task_handler_cb_t handler,
+                          void *ctx, uint8_t with_ctx)
+{
+    if (task_type >= TASK_COUNT)
+    {
+        return;
+    }
+
+    task_tcb_t *task = &s->rate[task_type];
+
+    TASK_ENTER_CRITICAL();
+
+    if ((handler != NULL) && (task->handler == NULL))
+    {
+        // First registration: releases stay aligned to the 1 second boundary
+        task->period = task_ticks[task_type];
+        task->phase = 0;
+        task->index = (uint16_t)task_type;
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+        task->priority = task_rm_priority(task->period);
+#endif
+#if (TASK_CFG_OVERRUN != 0)
+        task->overrun = TASK_OVERRUN_COALESCE;
+        task->served = task->releases;
+#endif
+        task_link(s, task);
+    }
+    else if ((handler == NULL) && (task->handler != NULL))
+    {
+        task_unlink(s, task);
+    }
+
+    task_bind(task, handler, ctx, with_ctx);
+
+    TASK_EXIT_CRITICAL();
+}
+
+/**
+ * @brief
+ * Schedule a handler from the pool, see task_add(). Period 0 makes a chain stage,
+ * which is not scheduled on its own.
+ */
+static task_tcb_t *task_create(task_scheduler_t *s, uint32_t period, uint32_t phase, uint16_t slices,
+                               task_handler_cb_t handler, void *ctx, uint8_t with_ctx)
+{
+    task_tcb_t *task;
+
+    if (handler == NULL)
+    {
+        return NULL;
+    }
+
+    TASK_ENTER_CRITICAL();
+
+    task = s->free;
+
+    if (task != NULL)
+    {
+        s->free = task->next;
+
+        task_bind(task, handler, ctx, with_ctx);
+        task->period = period;
+        task->phase = (period != 0U) ? (phase % period) : 0U;
+#if (TASK_CFG_SLICES != 0)
+        task->slices = slices;
+        task->slice = 0;
+#else
+        (void)slices;
+#endif
+        task->overflow_count = 0;
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+        task->priority = task_rm_priority((period != 0U) ? period : 1U);
+#endif
+#if (TASK_CFG_CHAINS != 0)
+        task->succ = NULL;
+        task->stage = (period == 0U);
+        task->deps = 0;
+        task->waiting = 0;
+#endif
+#if (TASK_CFG_BUDGET != 0)
+        task->budget = 0;
+        task->budget_overruns = 0;
+#endif
+#if (TASK_CFG_OVERRUN != 0)
+        task->overrun = TASK_OVERRUN_COALESCE;
+        task->served = task->releases;
+#endif
+#if (TASK_CFG_STATS != 0)
+        task_reset_stats(task);
+#endif
+#if (TASK_CFG_ANALYSIS != 0)
+        task->wcet = 0;
+        task->response = 0;
+#endif
+        if (period != 0U)
+        {
+            task_link(s, task);
+        }
+    }
+
+    TASK_EXIT_CRITICAL();
+
+    return task;
+}
+
+#if (TASK_CFG_ANALYSIS != 0)
+/**
+ * @brief
+ * Execution time of one handler run: the declared WCET, or the longest measured
+ * run when that is longer.
+ */
+static uint64_t task_analysis_wcet(const task_tcb_t *task)
+{
+    uint64_t wcet = task->wcet;
+
+#if (TASK_CFG_STATS != 0)
+    if (task->stats.exec_max > wcet)
+    {
+        wcet = task->stats.exec_max;
+    }
+#endif
+
+    return wcet;
+}
+
+/**
+ * @brief
+ * Execution time of one release: the handler plus every chain stage it may complete.
+ * A stage runs at most once per release however many paths reach it, so each reachable
+ * stage counts once; a bitmap over the task indices marks the stages already counted,
+ * which also visits every edge only once. Pending sibling edges wait on a local stack.
+ */
+static uint64_t task_analysis_cost(const task_tcb_t *task)
+{
+    uint64_t cost = task_analysis_wcet(task);
+
+#if (TASK_CFG_CHAINS != 0)
+    const task_edge_t *stack[TASK_CFG_MAX_TASKS + 1U];
+    uint32_t seen[TASK_READY_WORDS] = { 0 };
+    uint16_t depth = 0;
+
+    seen[task->index >> 5] |= TASK_READY_BIT(task->index);
+
+    if (task->succ != NULL)
+    {
+        stack[depth++] = task->succ;
+    }
+
+    while (depth != 0U)
+    {
+        const task_edge_t *edge = stack[--depth];
+        const task_tcb_t *stage = edge->to;
+
+        if (edge->next != NULL)
+        {
+            stack[depth++] = edge->next;
+        }
+
+        if ((seen[stage->index >> 5] & TASK_READY_BIT(stage->index)) != 0U)
+        {
+            continue;
+        }
+
+        seen[stage->index >> 5] |= TASK_READY_BIT(stage->index);
+        cost += task_analysis_wcet(stage);
+
+        // Pushed once per counted stage, so the stack never holds more than the task count
+        if ((stage->succ != NULL) && (depth <= TASK_CFG_MAX_TASKS))
+        {
+            stack[depth++] = stage->succ;
+        }
+    }
+#endif
+
+    return cost;
+}
+
+/**
+ * @brief
+ * Describe a task for the analysis. A sliced task is a task of period / slices ticks.
+ */
+static void task_analysis_item(task_analysis_item_t *item, const task_tcb_t *task)
+{
+    uint32_t gap = task->period;
+
+#if (TASK_CFG_SLICES != 0)
+    if (task->slices != 0U)
+    {
+        gap /= task->slices;
+    }
+#endif
+
+    item->task = task;
+    item->cost = task_analysis_cost(task);
+    item->gap = ((uint64_t)gap * (uint64_t)(TASK_CFG_CYCLES_HZ)) / TASK_CFG_TICK_HZ;
+    item->index = task->index;
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+    item->level = task->priority;
+#else
+    item->level = 0;
+#endif
+}
+
+/**
+ * @brief
+ * Next member of the analysed set: the active list, followed by the task_admit()
+ * candidate `extra` (NULL when there is none).
+ */
+static const task_tcb_t *task_analysis_next(const task_tcb_t *task, const task_tcb_t *extra)
+{
+    return ((task->next == NULL) && (task != extra)) ? extra : task->next;
+}
+
+/**
+ * @brief
+ * Whether a task takes part in the analysis: scheduled, and not suspended or shed.
+ */
+static uint8_t task_analysis_counted(const task_tcb_t *task, const task_tcb_t *extra)
+{
+    if (task == extra)
+    {
+        return 1;
+    }
+
+    if (task->handler == NULL)
+    {
+        return 0;
+    }
+
+#if (TASK_CFG_RETUNE != 0)
+    if (task->suspended)
+    {
+        return 0;
+    }
+#endif
+#if (TASK_CFG_SHED != 0)
+    if (task->shed == TASK_SHED_SUSPEND)
+    {
+        return 0;
+    }
+#endif
+
+    return 1;
+}
+
+/**
+ * @brief
+ * Whether task_handler() takes `a` before `b` when both are pending.
+ */
+static uint8_t task_analysis_before(const task_analysis_item_t *a, const task_analysis_item_t *b)
+{
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_EDF)
+    return (a->gap < b->gap) || ((a->gap == b->gap) && (a->index < b->index));
+#else
+    return (a->level < b->level) || ((a->level == b->level) && (a->index < b->index));
+#endif
+}
+
+#if (TASK_CFG_DISPATCH != TASK_DISPATCH_EDF)
+/**
+ * @brief
+ * Whether `a` interrupts a running `b`: only from a more urgent preemptive level.
+ */
+static uint8_t task_analysis_preempts(const task_analysis_item_t *a, const task_analysis_item_t *b)
+{
+#if (TASK_CFG_PREEMPT_LEVELS > 0)
+    return (a->level < TASK_CFG_PREEMPT_LEVELS) && (a->level < b->level);
+#else
+    (void)a;
+    (void)b;
+    return 0;
+#endif
+}
+
+/**
+ * @brief
+ * Response-time bound of `item` under fixed priority dispatch (index order or rate
+ * monotonic levels), using the sufficient non-preemptive analysis of Davis et al.:
+ * a release waits for the longest run it cannot preempt among the tasks it does not
+ * outrank (itself included, for its previous release), then for every release of a
+ * more urgent task until it starts. Tasks on more urgent preemptive levels also
+ * interrupt its own run:
+ *   R = B + C + sum (floor((R - C) / T) + 1) * C_hp + sum ceil(R / T) * C_preempt
+ * Index order selects once per task_handler() pass, not per run: a release just after
+ * the pass (or ready mask snapshot) went by waits for the rest of it, which may hold
+ * one run of every task. B is the sum of all costs there. The iteration stops at the
+ * first value above the period.
+ */
+static uint64_t task_analysis_response(task_scheduler_t *s, const task_analysis_item_t *item,
+                                       const task_tcb_t *extra)
+{
+    const task_tcb_t *first = (s->active != NULL) ? s->active : extra;
+    task_analysis_item_t other;
+    uint64_t blocking = item->cost;
+
+    for (const task_tcb_t *task = first; task != NULL; task = task_analysis_next(task, extra))
+    {
+        if ((task == item->task) || !task_analysis_counted(task, extra))
+        {
+            continue;
+        }
+
+        task_analysis_item(&other, task);
+
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_INDEX)
+        blocking += other.cost;
+#else
+        if (!task_analysis_before(&other, item) && !task_analysis_preempts(item, &other) &&
+            (other.cost > blocking))
+        {
+            blocking = other.cost;
+        }
+#endif
+    }
+
+    uint64_t response = blocking + item->cost;
+
+    for (;;)
+    {
+        uint64_t next = blocking + item->cost;
+
+        for (const task_tcb_t *task = first; task != NULL; task = task_analysis_next(task, extra))
+        {
+            if ((task == item->task) || !task_analysis_counted(task, extra))
+            {
+                continue;
+            }
+
+            task_analysis_item(&other, task);
+
+            if ((other.gap == 0U) || !task_analysis_before(&other, item))
+            {
+                continue;
+            }
+
+            if (task_analysis_preempts(&other, item))
+            {
+                next += ((response + other.gap - 1U) / other.gap) * other.cost;
+            }
+            else
+            {
+                next += (((response - item->cost) / other.gap) + 1U) * other.cost;
+            }
+        }
+
+        if ((next == response) || (next > item->gap))
+        {
+            return next;
+        }
+
+        response = next;
+    }
+}
+
+/**
+ * @brief
+ * Liu & Layland utilisation bound n * (2^(1/n) - 1) in ppm; beyond the table the
+ * series ln 2 + (ln 2)^2 / 2n, which stays below the exact value. The bound holds for
+ * fully preemptive RM only, so the report carries it for comparison and the verdict
+ * comes from the response bounds.
+ */
+static uint32_t task_analysis_rm_bound(uint16_t tasks)
+{
+    static const uint32_t bound[8] = { 1000000, 828427, 779763, 756828, 743491, 734772, 728626, 724061 };
+
+    if (tasks == 0U)
+    {
+        return 1000000UL;
+    }
+
+    return (tasks <= 8U) ? bound[tasks - 1U] : (693147UL + (240226UL / tasks));
+}
+#endif
+
+/**
+ * @brief
+ * Analyse the task set plus the candidate `extra` (NULL for none). With `store` the
+ * response bound of every task is kept in its TCB. Returns 1 when no task misses.
+ */
+static uint8_t task_analysis_run(task_scheduler_t *s, const task_tcb_t *extra, task_analysis_t *report,
+                                 uint8_t store)
+{
+    const task_tcb_t *first = (s->active != NULL) ? s->active : extra;
+    task_analysis_t result = { 0 };
+    task_analysis_item_t item;
+    uint64_t utilisation = 0;
+
+    for (const task_tcb_t *task = first; task != NULL; task = task_analysis_next(task, extra))
+    {
+        if (!task_analysis_counted(task, extra))
+        {
+            continue;
+        }
+
+        task_analysis_item(&item, task);
+
+        result.tasks++;
+
+        if (item.cost == 0U)
+        {
+            result.unmeasured++;
+        }
+
+        if (item.gap != 0U)
+        {
+            // Rounded up, so the sum never understates the load
+            utilisation += ((item.cost * 1000000ULL) + item.gap - 1U) / item.gap;
+        }
+        else if (item.cost != 0U)
+        {
+            utilisation += 1000000ULL;
+        }
+    }
+
+    result.utilisation = (utilisation > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)utilisation;
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_EDF)
+    result.bound = 1000000UL;
+#else
+    result.bound = task_analysis_rm_bound(result.tasks);
+#endif
+
+    for (const task_tcb_t *task = first; task != NULL; task = task_analysis_next(task, extra))
+    {
+        if (!task_analysis_counted(task, extra))
+        {
+            continue;
+        }
+
+        task_analysis_item(&item, task);
+
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_EDF)
+        // Non-preemptive EDF, sufficient: U * T + B <= T, with B the longest run of a
+        // task with a later relative deadline, which may have just started
+        uint64_t blocking = 0;
+        task_analysis_item_t other;
+
+        for (const task_tcb_t *it = first; it != NULL; it = task_analysis_next(it, extra))
+        {
+            if ((it == task) || !task_analysis_counted(it, extra))
+            {
+                continue;
+            }
+
+            task_analysis_item(&other, it);
+
+            if (task_analysis_before(&item, &other) && (other.cost > blocking))
+            {
+                blocking = other.cost;
+            }
+        }
+
+        // A demand bound for the test, not a response time: EDF may start a task any time up to its deadline
+        uint64_t response = blocking + ((item.gap / 1000000ULL) * utilisation) +
+                            (((item.gap % 1000000ULL) * utilisation) / 1000000ULL);
+#else
+        uint64_t response = task_analysis_response(s, &item, extra);
+#endif
+        int64_t slack = (int64_t)item.gap - (int64_t)response;
+
+        if (response > item.gap)
+        {
+            result.misses++;
+        }
+
+        if ((result.critical == NULL) || (slack < result.slack))
+        {
+            result.critical = (task_tcb_t *)task;
+            result.slack = slack;
+        }
+
+        if (store && (task != extra))
+        {
+            ((task_tcb_t *)task)->response = response;
+        }
+    }
+
+    // The candidate is no task of the set
+    if ((extra != NULL) && (result.critical == extra))
+    {
+        result.critical = NULL;
+    }
+
+    if (report != NULL)
+    {
+        *report = result;
+    }
+
+    return (result.misses == 0U) && (utilisation <= 1000000ULL);
+}
+#endif
+
+/* Function Definitions ------------------------------------------------------*/
+
+/**
+ * @brief
+ * Increment the tick count and set the flags for tasks based on their frequencies.
+ */
+TASK_PORT_FAST_CODE void task_tick(void)
+{
+    task_scheduler_t *s = task_self();
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+    uint32_t released[1] = {0};                    // Levels that received a release
+#elif (TASK_CFG_READY_MASK != 0)
+    uint32_t released[TASK_READY_WORDS] = {0};
+#else
+    uint32_t *released = NULL;
+#endif
+
+#if (TASK_CFG_STATS != 0)
+    uint32_t now = TASK_PORT_CYCLES();
+#else
+    uint32_t now = 0;
+#endif
+
+    if (++s->tick_count == 0U)
+    {
+        s->tick_epoch++;
+    }
+
+#if (TASK_CFG_ENGINE == TASK_ENGINE_HEAP)
+    // Only the tasks due on this tick are touched; the root is always the next release
+    while ((s->heap_count != 0U) && ((int32_t)(s->tick_count - s->heap[0]->due) >= 0))
+    {
+        task_tcb_t *task = s->heap[0];
+
+        task->due += task_reload(s, task);
+        task_heap_down(s, 0);
+        task_release(s, task, released, now);
+    }
+#else
+    for (task_tcb_t *task = s->active; task != NULL; task = task->next)
+    {
+        // Check if it's time to run this task
+#if (TASK_CFG_ENGINE == TASK_ENGINE_COUNTDOWN)
+        if (--task->countdown != 0U)
+        {
+            continue;
+        }
+        task->countdown = task_reload(s, task);
+#else
+        if (!task_due_on(task, s->tick_count))
+        {
+            continue;
+        }
+        (void)task_reload(s, task);                // The modulo test follows the new period
+#endif
+
+        task_release(s, task, released, now);
+    }
+#endif
+
+    task_publish(s, released);
+
+#if (TASK_CFG_SHED != 0)
+    task_shed_check(s, 1, 0);
+#endif
+
+#if (TASK_CFG_TIMERS != 0)
+    task_timer_expire(s, 1);
+#endif
+
+#if (TASK_CFG_BUDGET != 0)
+    task_budget_scan(s);
+#endif
+}
+
+/**
+ * @brief
+ * Advance `ticks` ticks in one call, with the same releases, pending tasks and overflow
+ * counts as `ticks` calls to task_tick(). The releases each task missed are computed
+ * arithmetically, so the cost follows the task count, not `ticks`. For batched tick
+ * sources: a fast timer serviced every few ticks, or a hardware counter read by DMA.
+ * With TASK_CFG_SHED the shed windows the step completes all close at its end, see
+ * task_shed_check(); a level reached inside the step applies from the next release.
+ */
+TASK_PORT_FAST_CODE void task_tick_n(uint32_t ticks)
+{
+    task_scheduler_t *s = task_self();
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+    uint32_t released[1] = {0};                    // Levels that received a release
+#elif (TASK_CFG_READY_MASK != 0)
+    uint32_t released[TASK_READY_WORDS] = {0};
+#else
+    uint32_t *released = NULL;
+#endif
+
+#if (TASK_CFG_STATS != 0)
+    uint32_t now = TASK_PORT_CYCLES();
+#else
+    uint32_t now = 0;
+#endif
+
+    uint32_t from = s->tick_count;
+#if (TASK_CFG_SHED != 0)
+    uint32_t shed_before = s->shed_overflows;
+#endif
+
+    if (ticks == 0U)
+    {
+        return;
+    }
+
+#if (TASK_CFG_ENGINE == TASK_ENGINE_HEAP)
+    // Only the tasks due within the step are touched, each once
+    while ((s->heap_count != 0U) && ((s->heap[0]->due - from) <= ticks))
+    {
+        task_tcb_t *task = s->heap[0];
+
+        task->due = from + task_release_n(s, task, released, now, from, task->due - from, ticks);
+        task_heap_down(s, 0);
+    }
+#else
+    for (task_tcb_t *task = s->active; task != NULL; task = task->next)
+    {
+#if (TASK_CFG_ENGINE == TASK_ENGINE_COUNTDOWN)
+        uint32_t first = task->countdown;
+#else
+        uint32_t first = task_first_release(s, task);
+#endif
+        uint32_t next = task_release_n(s, task, released, now, from, first, ticks);
+
+#if (TASK_CFG_ENGINE == TASK_ENGINE_COUNTDOWN)
+        task->countdown = next - ticks;
+#else
+        (void)next;
+#endif
+    }
+#endif
+
+    s->tick_count = from + ticks;
+
+    if (s->tick_count < from)
+    {
+        s->tick_epoch++;
+    }
+
+    task_publish(s, released);
+
+#if (TASK_CFG_SHED != 0)
+    task_shed_check(s, ticks, s->shed_overflows - shed_before);
+#endif
+
+#if (TASK_CFG_TIMERS != 0)
+    task_timer_expire(s, ticks);
+#endif
+
+#if (TASK_CFG_BUDGET != 0)
+    task_budget_scan(s);
+#endif
+}
+
+/**
+ * @brief
+ * Check if any task flags are set. If a flag is set, reset it and call the handler.
+ */
+TASK_PORT_FAST_CODE void task_handler(void)
+{
+    task_scheduler_t *s = task_self();
+
+#if (TASK_CFG_EVENTS != 0)
+    // Deferred interrupt work first, it is short and waits on latency
+    for (task_queue_t *queue = s->queues; queue != NULL; queue = queue->next)
+    {
+        task_queue_drain(queue);
+    }
+#endif
+
+#if (TASK_CFG_TIMERS != 0)
+    task_timer_run(s);
+#endif
+
+#if (TASK_CFG_DISPATCH != TASK_DISPATCH_INDEX)
+    // Select again after every handler so releases that arrived meanwhile are taken in order;
+    // bounded by the task count so an overloaded system still returns to the main loop
+    for (uint16_t n = s->active_count; (n != 0U) && task_handler_one(); n--)
+    {
+    }
+#elif (TASK_CFG_READY_MASK != 0)
+    for (uint16_t w = 0; w < TASK_READY_WORDS; w++)
+    {
+        // Take every pending task at once; releases arriving from now on stay in the mask
+        uint32_t ready = TASK_ATOMIC_EXCHANGE(&s->ready[0][w], 0U);
+
+        while (ready != 0U)
+        {
+            task_tcb_t *task = task_from_index(s, (uint16_t)((w << 5) + TASK_CTZ(ready)));
+            ready &= ready - 1U;
+
+            (void)task_dispatch(s, task);
+        }
+    }
+#else
+    task_tcb_t *next;
+
+    for (task_tcb_t *task = s->active; task != NULL; task = next)
+    {
+        // Fetched first so a handler may remove its own task
+        next = task->next;
+
+        if (task->flag)
+        {
+            // Clear flag first to allow re-triggering if handler takes too long (optional safety)
+            task->flag = 0;
+
+            (void)task_dispatch(s, task);
+        }
+    }
+#endif
+
+#if (TASK_CFG_IDLE != 0)
+    task_idle(s);
+#endif
+}
+
+/**
+ * @brief
+ * Run at most one pending task, the most urgent one under TASK_CFG_DISPATCH.
+ * Returns 1 if a task was taken, 0 if nothing was pending.
+ */
+TASK_PORT_FAST_CODE uint8_t task_handler_one(void)
+{
+    task_scheduler_t *s = task_self();
+#if (TASK_CFG_READY_MASK != 0)
+    task_tcb_t *task = task_claim(s);
+
+    if (task == NULL)
+    {
+        return 0;
+    }
+
+    (void)task_dispatch(s, task);
+
+    return 1;
+#else
+    for (task_tcb_t *task = s->active; task != NULL; task = task->next)
+    {
+        if (task->flag)
+        {
+            task->flag = 0;
+
+            (void)task_dispatch(s, task);
+
+            return 1;
+        }
+    }
+
+    return 0;
+#endif
+}
+
+#if (TASK_CFG_HOST_WORKERS > 0)
+/**
+ * @brief
+ * task_handler() for an instance whose tasks other threads claim as well: the events
+ * and timers, then at most one task through task_handler_one(), and the idle pass
+ * when nothing was pending. Run in a loop, it keeps the events and timers waiting
+ * for one handler at most. Returns 1 if a task was taken, 0 otherwise.
+ */
+TASK_PORT_FAST_CODE uint8_t task_handler_shared(void)
+{
+    task_scheduler_t *s = task_self();
+
+#if (TASK_CFG_EVENTS != 0)
+    for (task_queue_t *queue = s->queues; queue != NULL; queue = queue->next)
+    {
+        task_queue_drain(queue);
+    }
+#endif
+
+#if (TASK_CFG_TIMERS != 0)
+    task_timer_run(s);
+#endif
+
+    if (task_handler_one())
+    {
+        return 1;
+    }
+
+#if (TASK_CFG_IDLE != 0)
+    task_idle(s);
+#else
+    (void)s;
+#endif
+
+    return 0;
+}
+#endif
+
+/**
+ * @brief
+ * Returns 1 if a released task is waiting for task_handler(), 0 otherwise.
+ */
+uint8_t task_pending(void)
+{
+    task_scheduler_t *s = task_self();
+
+#if (TASK_CFG_READY_MASK != 0)
+    for (uint8_t level = 0; level < TASK_READY_LEVELS; level++)
+    {
+        for (uint16_t w = 0; w < TASK_READY_WORDS; w++)
+        {
+            if (TASK_ATOMIC_LOAD(&s->ready[level][w]) != 0U)
+            {
+                return 1;
+            }
+        }
+    }
+#else
+    for (task_tcb_t *task = s->active; task != NULL; task = task->next)
+    {
+        if (task->flag)
+        {
+            return 1;
+        }
+    }
+#endif
+
+#if (TASK_CFG_TIMERS != 0)
+    if (s->expired != NULL)
+    {
+        return 1;
+    }
+#endif
+
+    return 0;
+}
+
+/**
+ * @brief
+ * Register a task handler for a specific task type. A NULL handler stops the task.
+ */
+void task_register_handler(task_type_t task_type, task_handler_cb_t handler)
+{
+    task_scheduler_t *s = task_self();
+
+    task_register(s, task_type, handler, NULL, 0);
+}
+
+#if (TASK_CFG_HANDLER_CTX != 0)
+/**
+ * @brief
+ * task_register_handler() for a handler called as `handler(ctx)`.
+ */
+void task_register_handler_ctx(task_type_t task_type, task_handler_ctx_cb_t handler, void *ctx)
+{
+    task_scheduler_t *s = task_self();
+
+    task_register(s, task_type, (task_handler_cb_t)handler, ctx, 1);
+}
+#endif
+
+/**
+ * @brief
+ * Hand the scheduler a statically allocated block array for dynamic tasks.
+ * Call once at startup, before the first task_add().
+ */
+void task_pool_init(task_tcb_t *pool, uint16_t count)
+{
+    task_scheduler_t *s = task_self();
+
+    if ((pool == NULL) || (s->pool != NULL))
+    {
+        return;
+    }
+
+    if (count > (TASK_CFG_MAX_TASKS - TASK_COUNT))
+    {
+        count = TASK_CFG_MAX_TASKS - TASK_COUNT;
+    }
+
+    // Chain every block into the free list, last block first so allocation is in pool order
+    s->free = NULL;
+
+    for (uint16_t i = count; i > 0; i--)
+    {
+        task_tcb_t *task = &pool[i - 1U];
+
+        task->handler = NULL;
+        task->index = (uint16_t)(TASK_COUNT + i - 1U);
+        task->next = s->free;
+        s->free = task;
+    }
+
+    s->pool = pool;
+    s->pool_count = count;
+}
+
+/**
+ * @brief
+ * Schedule a handler every `period` ticks, released on ticks where tick % period == phase.
+ * Returns the task control block, or NULL if the pool is exhausted or the arguments are invalid.
+ */
+task_tcb_t *task_add(uint32_t period, uint32_t phase, task_handler_cb_t handler)
+{
+    task_scheduler_t *s = task_self();
+
+    if (period == 0U)
+    {
+        return NULL;
+    }
+
+    return task_create(s, period, phase, 0, handler, NULL, 0);
+}
+
+#if (TASK_CFG_HANDLER_CTX != 0)
+/**
+ * @brief
+ * task_add() for a handler called as `handler(ctx)`, so instances of one handler body
+ * differ only in their context pointer.
+ */
+task_tcb_t *task_add_ctx(uint32_t period, uint32_t phase, task_handler_ctx_cb_t handler, void *ctx)
+{
+    task_scheduler_t *s = task_self();
+
+    if (period == 0U)
+    {
+        return NULL;
+    }
+
+    return task_create(s, period, phase, 0, (task_handler_cb_t)handler, ctx, 1);
+}
+#endif
+
+#if (TASK_CFG_SLICES != 0)
+/**
+ * @brief
+ * Schedule work that is split into `slices` parts, e.g. 64 sensors scanned once per
+ * second: `handler(k)` runs for slice k on tick phase + floor(k * period / slices) of
+ * each period, so the work is spread evenly instead of landing on one tick. Needs
+ * 1 <= slices <= period. Each slice is a release of its own: a slice that has not run
+ * when the next one is released counts as an overflow. Returns NULL on bad arguments
+ * or when the pool is exhausted.
+ */
+task_tcb_t *task_add_sliced(uint32_t period, uint32_t phase, uint16_t slices, task_slice_cb_t handler)
+{
+    task_scheduler_t *s = task_self();
+
+    if ((period == 0U) || (slices == 0U) || (slices > period))
+    {
+        return NULL;
+    }
+
+    return task_create(s, period, phase, slices, (task_handler_cb_t)handler, NULL, 0);
+}
+#endif
+
+#if (TASK_CFG_CHAINS != 0)
+/**
+ * @brief
+ * Take a pipeline stage from the pool: a handler without a period of its own that
+ * runs when all of its predecessors (task_chain()) have run. Returns NULL when the
+ * pool is exhausted.
+ */
+task_tcb_t *task_add_stage(task_handler_cb_t handler)
+{
+    task_scheduler_t *s = task_self();
+
+    return task_create(s, 0, 0, 0, handler, NULL, 0);
+}
+
+#if (TASK_CFG_HANDLER_CTX != 0)
+/**
+ * @brief
+ * task_add_stage() for a context handler, called as `handler(ctx)`.
+ */
+task_tcb_t *task_add_stage_ctx(task_handler_ctx_cb_t handler, void *ctx)
+{
+    task_scheduler_t *s = task_self();
+
+    return task_create(s, 0, 0, 0, (task_handler_cb_t)handler, ctx, 1);
+}
+#endif
+
+/**
+ * @brief
+ * Run stage `after` once `before` has run, in the same task_handler() pass. `before`
+ * is a periodic task or another stage; a stage with several predecessors runs after
+ * the last of them, so they should share a release period. The edges must form a
+ * DAG; build it at start-up, a chained task is not removed. Returns 1 on success.
+ */
+uint8_t task_chain(task_tcb_t *before, task_tcb_t *after, task_edge_t *edge)
+{
+    if ((before == NULL) || (after == NULL) || (edge == NULL) || (before == after) ||
+        (after->stage == 0U) || (after->deps == 0xFFU))
+    {
+        return 0;
+    }
+
+    TASK_ENTER_CRITICAL();
+
+    // Appended so sibling stages run in the order they were chained
+    task_edge_t **link = &before->succ;
+
+    while (*link != NULL)
+    {
+        link = &(*link)->next;
+    }
+
+    edge->next = NULL;
+    edge->to = after;
+    *link = edge;
+
+    after->deps++;
+    after->waiting++;
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+    // A stage handed to another worker waits on the level of its first predecessor
+    if (after->deps == 1U)
+    {
+        after->priority = before->priority;
+    }
+#endif
+
+    TASK_EXIT_CRITICAL();
+
+    return 1;
+}
+#endif
+
+/**
+ * @brief
+ * Stop a dynamic task and return its block to the pool. Safe to call from the task's own handler.
+ */
+void task_remove(task_tcb_t *task)
+{
+    if ((task == NULL) || (task->index < TASK_COUNT) || (task->handler == NULL))
+    {
+        return;
+    }
+
+#if (TASK_CFG_CHAINS != 0)
+    if ((task->succ != NULL) || (task->deps != 0U))
+    {
+        return;
+    }
+#endif
+
+    task_scheduler_t *s = task_owner(task);
+
+    TASK_ENTER_CRITICAL();
+
+    task_unlink(s, task);
+    task->handler = NULL;
+    task->next = s->free;
+    s->free = task;
+
+    TASK_EXIT_CRITICAL();
+}
+
+#if (TASK_CFG_OVERRUN != 0)
+/**
+ * @brief
+ * Choose how a task handles releases that arrive before the previous one ran.
+ * Call right after registration; a backlog collected so far is discarded.
+ */
+void task_set_overrun(task_tcb_t *task, task_overrun_t policy)
+{
+    if ((task == NULL) || (task->handler == NULL) || (policy > TASK_OVERRUN_SKIP))
+    {
+        return;
+    }
+
+    TASK_ENTER_CRITICAL();
+
+    task->overrun = (uint8_t)policy;
+    task->served = task->releases;
+
+    TASK_EXIT_CRITICAL();
+}
+#endif
+
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+/**
+ * @brief
+ * Override the rate monotonic level of a task (0 = most urgent). A pending release
+ * moves along to the new level.
+ */
+void task_set_priority(task_tcb_t *task, uint8_t priority)
+{
+    if (task == NULL)
+    {
+        return;
+    }
+
+    if (priority >= TASK_CFG_PRIORITY_LEVELS)
+    {
+        priority = TASK_CFG_PRIORITY_LEVELS - 1U;
+    }
+
+    task_scheduler_t *s = task_owner(task);
+
+    TASK_ENTER_CRITICAL();
+
+    uint32_t bit = TASK_READY_BIT(task->index);
+    uint32_t pending = TASK_ATOMIC_FETCH_AND(task_ready_word(s, task), ~bit) & bit;
+
+    task->priority = priority;
+
+    if (pending != 0U)
+    {
+        task_pend(s, task);
+    }
+
+    TASK_EXIT_CRITICAL();
+}
+#endif
+
+#if (TASK_CFG_PREEMPT_LEVELS > 0)
+/**
+ * @brief
+ * Run the pending tasks of one preemptive level. Call from the software interrupt
+ * that TASK_PORT_PEND(level) triggers; more urgent levels may preempt it.
+ */
+TASK_PORT_FAST_CODE void task_preempt_dispatch(uint8_t level)
+{
+    task_scheduler_t *s = task_self();
+
+    if (level >= TASK_CFG_PREEMPT_LEVELS)
+    {
+        return;
+    }
+
+    // Bounded like task_handler() so a level that is permanently overloaded still returns
+    for (uint16_t n = s->active_count; n != 0U; n--)
+    {
+        task_tcb_t *task = task_claim_level(s, level);
+
+        if (task == NULL)
+        {
+            break;
+        }
+
+        (void)task_dispatch(s, task);
+    }
+}
+#endif
+
+#if (TASK_CFG_CORES > 1)
+/**
+ * @brief
+ * Allow (TASK_AFFINITY_ANY) or forbid (TASK_AFFINITY_PINNED) other cores to run the
+ * releases of a task through task_steal(). Tasks start pinned to the core that
+ * registered them, and are pinned again when removed.
+ */
+void task_set_affinity(task_tcb_t *task, uint8_t affinity)
+{
+    if ((task == NULL) || (task->handler == NULL))
+    {
+        return;
+    }
+
+    task_scheduler_t *s = task_owner(task);
+    TASK_ATOMIC_U32 *word = &s->stealable[task->index >> 5];
+
+    if (affinity == TASK_AFFINITY_ANY)
+    {
+        (void)TASK_ATOMIC_FETCH_OR(word, TASK_READY_BIT(task->index));
+    }
+    else
+    {
+        (void)TASK_ATOMIC_FETCH_AND(word, ~TASK_READY_BIT(task->index));
+    }
+}
+
+/**
+ * @brief
+ * Take one pending, stealable task of another core and run it on this core.
+ * Call from the main loop of a core whose own task_handler() found nothing to do.
+ * Preemptive levels are never taken. Returns 1 if a handler ran, 0 otherwise.
+ */
+uint8_t task_steal(void)
+{
+    task_scheduler_t *self = task_self();
+
+    for (uint8_t core = 0; core < TASK_CFG_CORES; core++)
+    {
+        task_scheduler_t *s = &schedulers[core];
+
+        if (s == self)
+        {
+            continue;
+        }
+
+        for (uint8_t level = TASK_CFG_PREEMPT_LEVELS; level < TASK_READY_LEVELS; level++)
+        {
+            for (uint16_t w = 0; w < TASK_READY_WORDS; w++)
+            {
+                uint32_t ready = TASK_ATOMIC_LOAD(&s->ready[level][w]) & TASK_ATOMIC_LOAD(&s->stealable[w]);
+
+                while (ready != 0U)
+                {
+                    uint32_t bit = ready & (0U - ready);
+                    ready &= ~bit;
+
+                    // Same claim as the owner's, so each release runs exactly once
+                    if (((TASK_ATOMIC_FETCH_AND(&s->ready[level][w], ~bit) & bit) != 0U) &&
+                        task_dispatch(s, task_from_index(s, (uint16_t)((w << 5) + TASK_CTZ(bit)))))
+                    {
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+#endif
+
+#if (TASK_CFG_EVENTS != 0)
+/**
+ * @brief
+ * Prepare an event queue on caller-provided storage. `capacity` must be a power
+ * of two (2..32768); other values are rounded down to one.
+ */
+void task_queue_init(task_queue_t *queue, task_event_t *slots, uint16_t capacity)
+{
+    if ((queue == NULL) || (slots == NULL) || (capacity < 2U))
+    {
+        return;
+    }
+
+    if (capacity > 0x8000U)
+    {
+        capacity = 0x8000U;
+    }
+
+    queue->next = NULL;
+    queue->slots = slots;
+    queue->mask = (uint16_t)((1UL << (31U - TASK_CLZ(capacity))) - 1U);
+    queue->head = 0;
+    queue->tail = 0;
+    queue->dropped = 0;
+}
+
+/**
+ * @brief
+ * Have task_handler() of the calling core drain a queue. Call once per queue at startup.
+ */
+void task_queue_attach(task_queue_t *queue)
+{
+    task_scheduler_t *s = task_self();
+
+    if ((queue == NULL) || (queue->slots == NULL))
+    {
+        return;
+    }
+
+    TASK_ENTER_CRITICAL();
+
+    // Append, so queues are drained in attach order
+    task_queue_t **link = &s->queues;
+
+    while ((*link != NULL) && (*link != queue))
+    {
+        link = &(*link)->next;
+    }
+
+    if (*link == NULL)
+    {
+        queue->next = NULL;
+        *link = queue;
+    }
+
+    TASK_EXIT_CRITICAL();
+}
+
+/**
+ * @brief
+ * Queue `cb(arg)` to run from the next task_handler() pass. Call from the one
+ * interrupt (or thread) that produces into this queue. Returns 1 if queued,
+ * 0 if the queue was full (counted in task_queue_get_dropped()).
+ */
+TASK_PORT_FAST_CODE uint8_t task_queue_post(task_queue_t *queue, task_event_cb_t cb, uintptr_t arg)
+{
+    uint16_t head = queue->head;
+
+    if ((uint16_t)(head - queue->tail) > queue->mask)
+    {
+        queue->dropped++;
+        return 0;
+    }
+
+    task_event_t *slot = &queue->slots[head & queue->mask];
+
+    slot->cb = cb;
+    slot->arg = arg;
+
+    // Slot written before the head that publishes it
+    TASK_MEMORY_BARRIER();
+    queue->head = (uint16_t)(head + 1U);
+
+    return 1;
+}
+#endif
+
+#if (TASK_CFG_TIMERS != 0)
+/**
+ * @brief
+ * Prepare an idle timer that calls `cb(arg)` from task_handler() when it expires.
+ */
+void task_timer_init(task_timer_t *timer, task_timer_cb_t cb, uintptr_t arg)
+{
+    if (timer == NULL)
+    {
+        return;
+    }
+
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->cb = cb;
+    timer->arg = arg;
+}
+
+/**
+ * @brief
+ * Arm a timer to expire `ticks` ticks from now (0 is taken as 1), on the same time
+ * base as the periodic tasks. An armed or expired timer is restarted. Call on the
+ * core that runs it; safe from interrupts of that core.
+ */
+void task_timer_start(task_timer_t *timer, uint32_t ticks)
+{
+    task_scheduler_t *s = task_self();
+
+    if ((timer == NULL) || (timer->cb == NULL))
+    {
+        return;
+    }
+
+    if (ticks == 0U)
+    {
+        ticks = 1U;
+    }
+
+    TASK_ENTER_CRITICAL();
+
+    task_timer_unlink(s, timer);
+    timer->expires = s->tick_count + ticks;
+    task_timer_link(&s->wheel[timer->expires & (TASK_CFG_TIMER_WHEEL - 1U)], timer);
+
+    TASK_EXIT_CRITICAL();
+}
+
+/**
+ * @brief
+ * Disarm a timer in O(1). An expired timer whose callback has not run yet is dropped too.
+ */
+void task_timer_cancel(task_timer_t *timer)
+{
+    task_scheduler_t *s = task_self();
+
+    if (timer == NULL)
+    {
+        return;
+    }
+
+    TASK_ENTER_CRITICAL();
+
+    task_timer_unlink(s, timer);
+
+    TASK_EXIT_CRITICAL();
+}
+#endif
+
+/**
+ * @brief
+ * Move the releases of a scheduled task to ticks where tick % period == phase.
+ * The next release is re-armed from the current tick.
+ */
+void task_set_phase(task_tcb_t *task, uint32_t phase)
+{
+    // Chain stages (period 0) have no releases to move
+    if ((task == NULL) || (task->handler == NULL) || (task->period == 0U))
+    {
+        return;
+    }
+
+    task_scheduler_t *s = task_owner(task);
+
+    TASK_ENTER_CRITICAL();
+
+    task->phase = phase % task->period;
+#if (TASK_CFG_ENGINE == TASK_ENGINE_HEAP)
+    task->due = s->tick_count + task_first_release(s, task);
+    task_heap_up(s, task->heap_slot);
+    task_heap_down(s, task->heap_slot);
+#else
+    task->countdown = task_first_release(s, task);
+#endif
+
+    TASK_EXIT_CRITICAL();
+}
+
+#if (TASK_CFG_RETUNE != 0)
+/**
+ * @brief
+ * Change the period of a task, e.g. to poll a sensor at 10 Hz instead of 100 Hz while
+ * nothing happens. The next release stays on the old period; from there on the task
+ * is released on ticks t % period == phase. Safe from interrupts and other tasks; the
+ * latest request before the release wins. The rate monotonic level is left as it is.
+ */
+void task_set_period(task_tcb_t *task, uint32_t period)
+{
+    if ((task == NULL) || (period == 0U))
+    {
+        return;
+    }
+
+#if (TASK_CFG_SLICES != 0)
+    if (period < task->slices)
+    {
+        return;
+    }
+#endif
+
+#if (TASK_CFG_SHED != 0)
+    // A task at half rate stays there: the shed factor applies on top of the new period
+    task->nominal = period;
+    task->period_req = (task->shed == TASK_SHED_HALF) ? (period * 2U) : period;
+#else
+    task->period_req = period;
+#endif
+}
+
+/**
+ * @brief
+ * Drop the releases of a task from the next one on. A release already pending still
+ * runs. Safe from interrupts; the task keeps its slot and release phase.
+ */
+void task_suspend(task_tcb_t *task)
+{
+    if (task != NULL)
+    {
+        task->suspended = 1;
+    }
+}
+
+/**
+ * @brief
+ * Release a suspended task again, on its next release tick. Safe from interrupts.
+ */
+void task_resume(task_tcb_t *task)
+{
+    if (task != NULL)
+    {
+        task->suspended = 0;
+    }
+}
+#endif
+
+#if (TASK_CFG_SHED != 0)
+/**
+ * @brief
+ * Set how early a scheduled task is shed under overload (TASK_CFG_SHED); tasks
+ * start at TASK_CRIT_HIGH. Call after registration, again after a re-registration.
+ */
+void task_set_criticality(task_tcb_t *task, task_criticality_t criticality)
+{
+    if ((task == NULL) || (task->handler == NULL) || (task->period == 0U) || (criticality > TASK_CRIT_HIGH))
+    {
+        return;
+    }
+
+    task_scheduler_t *s = task_owner(task);
+
+    TASK_ENTER_CRITICAL();
+
+    task->criticality = (uint8_t)criticality;
+    task_shed_apply(task, s->shed_level);
+
+    TASK_EXIT_CRITICAL();
+}
+
+/**
+ * @brief
+ * Current degradation step of the calling core: 0 = full rates, up to 4 = low and
+ * medium criticality tasks suspended.
+ */
+uint8_t task_get_shed_level(void)
+{
+    return task_self()->shed_level;
+}
+
+/**
+ * @brief
+ * Nominal releases a task lost to shedding so far: dropped while it was suspended, or
+ * skipped by its halved rate. Runs + overflows + shed count add up to the releases
+ * of its nominal schedule (sliced tasks: see task_shed_skip()).
+ */
+uint32_t task_get_shed_count(const task_tcb_t *task)
+{
+    if ((task == NULL) || (task->handler == NULL) || (task->period == 0U))
+    {
+        return 0;
+    }
+
+    task_scheduler_t *s = task_owner(task);
+    uint32_t count;
+    uint32_t ahead = 0;
+
+    TASK_ENTER_CRITICAL();
+
+    count = task->shed_count;
+
+#if (TASK_CFG_SLICES != 0)
+    if (task->slices == 0U)
+#endif
+    if (!task->suspended)
+    {
+        // Skips counted for the current gap that are still to come
+        uint32_t next = task_first_release(s, task);
+        uint32_t grid = task->nominal - (((s->tick_count % task->nominal) + task->nominal -
+                                          (task->phase % task->nominal)) % task->nominal);
+
+        if (grid < next)
+        {
+            ahead = 1U + ((next - 1U - grid) / task->nominal);
+        }
+    }
+
+    TASK_EXIT_CRITICAL();
+
+    return count - ahead;
+}
+#endif
+
+/**
+ * @brief
+ * Choose phase offsets for all scheduled tasks so their releases spread over the
+ * hyperperiod instead of all landing on the same tick.
+ *
+ * Tasks are placed shortest period first. Two tasks with periods a and b share a
+ * release tick exactly when their phases are equal modulo gcd(a, b), so each task
+ * takes the lowest phase that shares ticks with the fewest already placed tasks.
+ * Runs in O(N^2 * period) without extra memory; call it once after registration.
+ */
+void task_stagger(void)
+{
+    task_scheduler_t *s = task_self();
+    task_tcb_t *prev = NULL;
+
+    for (;;)
+    {
+        task_tcb_t *task = NULL;
+
+        // Next task in placement order after `prev`
+        for (task_tcb_t *it = s->active; it != NULL; it = it->next)
+        {
+            if (((prev == NULL) || task_stagger_before(prev, it)) &&
+                ((task == NULL) || task_stagger_before(it, task)))
+            {
+                task = it;
+            }
+        }
+
+        if (task == NULL)
+        {
+            break;
+        }
+
+        uint32_t best_phase = 0;
+        uint16_t best_hits = 0xFFFF;
+
+        for (uint32_t phase = 0; (phase < task->period) && (best_hits != 0U); phase++)
+        {
+            uint16_t hits = 0;
+
+            for (task_tcb_t *other = s->active; other != NULL; other = other->next)
+            {
+                if (task_stagger_before(other, task) &&
+                    (((phase + other->period - other->phase) % task_gcd(task->period, other->period)) == 0U))
+                {
+                    hits++;
+                }
+            }
+
+            if (hits < best_hits)
+            {
+                best_hits = hits;
+                best_phase = phase;
+            }
+        }
+
+        task_set_phase(task, best_phase);
+        prev = task;
+    }
+}
+
+/**
+ * @brief
+ * Least common multiple of all scheduled periods (the schedule repeats after it),
+ * saturating at 0xFFFFFFFF.
+ */
+uint32_t task_hyperperiod(void)
+{
+    task_scheduler_t *s = task_self();
+    uint32_t hyper = 1;
+
+    for (task_tcb_t *task = s->active; task != NULL; task = task->next)
+    {
+        uint32_t step = task->period / task_gcd(hyper, task->period);
+
+        if (hyper > (0xFFFFFFFFUL / step))
+        {
+            return 0xFFFFFFFFUL;
+        }
+
+        hyper *= step;
+    }
+
+    return hyper;
+}
+
+/**
+ * @brief
+ * Worst-case number of tasks released on the same tick over `horizon` ticks
+ * (0 = one hyperperiod, at most TASK_CFG_LOAD_HORIZON). The first tick reaching it
+ * is stored in `worst_tick` when not NULL. Walks every tick with a release test per
+ * task, O(horizon * N): the hyperperiod of unrelated periods grows with their product,
+ * and saturates at 0xFFFFFFFF. When the walk is shorter than the hyperperiod the
+ * result carries TASK_LOAD_TRUNCATED, as a lower bound. Start-up checks and host tools only.
+ */
+uint16_t task_schedule_load(uint32_t horizon, uint32_t *worst_tick)
+{
+    task_scheduler_t *s = task_self();
+    uint32_t hyper = task_hyperperiod();
+    uint16_t worst = 0;
+
+    if (horizon == 0U)
+    {
+        horizon = (hyper > TASK_CFG_LOAD_HORIZON) ? TASK_CFG_LOAD_HORIZON : hyper;
+    }
+
+    for (uint32_t tick = 1; tick <= horizon; tick++)
+    {
+        uint16_t load = 0;
+
+        for (task_tcb_t *task = s->active; task != NULL; task = task->next)
+        {
+            if (task_due_on(task, tick))
+            {
+                load++;
+            }
+        }
+
+        if (load > worst)
+        {
+            worst = load;
+
+            if (worst_tick != NULL)
+            {
+                *worst_tick = tick;
+            }
+        }
+
+        if (tick == 0xFFFFFFFFUL)
+        {
+            break;
+        }
+    }
+
+    // A saturated hyperperiod is longer than any walk
+    if ((horizon < hyper) || (hyper == 0xFFFFFFFFUL))
+    {
+        worst |= TASK_LOAD_TRUNCATED;
+    }
+
+    return worst;
+}
+
+#if (TASK_CFG_ANALYSIS != 0)
+/**
+ * @brief
+ * Declare the worst-case execution time of a task in TASK_PORT_CYCLES() units. The
+ * analysis uses it until a longer run is measured (TASK_CFG_STATS); 0 leaves only
+ * the measurements.
+ */
+void task_set_wcet(task_tcb_t *task, uint32_t cycles)
+{
+    if (task == NULL)
+    {
+        return;
+    }
+
+    task->wcet = cycles;
+}
+
+/**
+ * @brief
+ * Schedulability analysis of the current task set: keeps the response bound of every
+ * task (task_get_response_time(), the demand bound under EDF) and fills `report` when
+ * not NULL. Returns 1 when every task meets its deadline, its next release. The time
+ * of task_tick() itself is not included. Main loop only, O(N^2) per iteration step.
+ */
+uint8_t task_analyze(task_analysis_t *report)
+{
+    task_scheduler_t *s = task_self();
+
+    return task_analysis_run(s, NULL, report, 1);
+}
+
+/**
+ * @brief
+ * Admission test: would every deadline still hold with one more task of `period`
+ * ticks and `wcet` cycles, dispatched after the existing tasks of its level? Changes
+ * nothing; fills `report` for the extended set when not NULL. Returns 1 if it fits.
+ */
+uint8_t task_admit(uint32_t period, uint32_t wcet, task_analysis_t *report)
+{
+    task_scheduler_t *s = task_self();
+    task_tcb_t candidate = { 0 };
+
+    if (period == 0U)
+    {
+        return 0;
+    }
+
+    candidate.period = period;
+    candidate.index = TASK_CFG_MAX_TASKS;
+    candidate.wcet = wcet;
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+    candidate.priority = task_rm_priority(period);
+#endif
+
+    return task_analysis_run(s, &candidate, report, 0);
+}
+#endif
+
+/**
+ * @brief
+ * Number of task_tick() calls until the next one that releases a task (>= 1),
+ * or TASK_TICKS_NEVER if nothing is scheduled. Used to program a wake-up timer.
+ */
+uint32_t task_ticks_to_next(void)
+{
+    task_scheduler_t *s = task_self();
+    uint32_t next = TASK_TICKS_NEVER;
+
+#if (TASK_CFG_ENGINE == TASK_ENGINE_HEAP)
+    if (s->heap_count != 0U)
+    {
+        next = s->heap[0]->due - s->tick_count;
+    }
+#else
+    for (task_tcb_t *task = s->active; task != NULL; task = task->next)
+    {
+#if (TASK_CFG_ENGINE == TASK_ENGINE_COUNTDOWN)
+        uint32_t left = task->countdown;
+#else
+        uint32_t left = task_first_release(s, task);
+#endif
+
+        if (left < next)
+        {
+            next = left;
+        }
+    }
+#endif
+
+#if (TASK_CFG_TIMERS != 0)
+    // Armed timers wake up a tickless sleep like releases do
+    uint32_t timer = task_timer_next(s);
+
+    if (timer < next)
+    {
+        next = timer;
+    }
+#endif
+
+    return next;
+}
+
+/**
+ * @brief
+ * Catch up on `ticks` elapsed ticks after a tickless sleep, same as task_tick_n().
+ */
+void task_advance(uint32_t ticks)
+{
+    task_tick_n(ticks);
+}
+
+/**
+ * @brief
+ * Ticks since start, wrapping at 2^32. Subtract two readings for an elapsed time.
+ */
+uint32_t task_now(void)
+{
+    task_scheduler_t *s = task_self();
+
+    return *(const volatile uint32_t *)&s->tick_count;
+}
+
+/**
+ * @brief
+ * Ticks since start as a 64-bit count that does not wrap in practice.
+ */
+uint64_t task_time(void)
+{
+    task_scheduler_t *s = task_self();
+    uint64_t time;
+
+    TASK_ENTER_CRITICAL();
+
+    // Both words from the same tick, the tick interrupt carries into the epoch
+    time = ((uint64_t)s->tick_epoch << 32) | s->tick_count;
+
+    TASK_EXIT_CRITICAL();
+
+    return time;
+}
+
+/**
+ * @brief
+ * task_time() in microseconds, truncated to whole microseconds.
+ */
+uint64_t task_time_us(void)
+{
+    uint64_t ticks = task_time();
+
+    // Split so the multiplication cannot overflow for any tick count
+    return ((ticks / TASK_CFG_TICK_HZ) * 1000000ULL) + (((ticks % TASK_CFG_TICK_HZ) * 1000000ULL) / TASK_CFG_TICK_HZ);
+}
+
+/**
+ * @brief
+ * Control block of a built-in frequency task, for the monitoring functions.
+ */
+task_tcb_t *task_get(task_type_t task_type)
+{
+    task_scheduler_t *s = task_self();
+
+    return (task_type < TASK_COUNT) ? &s->rate[task_type] : NULL;
+}
+
+#if (TASK_CFG_IDLE != 0)
+/**
+ * @brief
+ * Register the function task_handler() calls when nothing is pending and no background
+ * job has work, e.g. `__WFI()`: the tick interrupt that releases the next task wakes it.
+ * NULL removes it.
+ */
+void task_register_idle_hook(task_idle_hook_t hook)
+{
+    task_self()->idle_hook = hook;
+}
+
+/**
+ * @brief
+ * Queue a background job. task_handler() calls `cb(arg)` in idle time, one bounded
+ * slice per call, until it returns 0. A slice checks task_should_yield() and returns
+ * when it is set. Main loop only; a queued job is left as it is.
+ */
+void task_job_start(task_job_t *job, task_job_cb_t cb, uintptr_t arg)
+{
+    task_scheduler_t *s = task_self();
+
+    if ((job == NULL) || (cb == NULL) || job->queued)
+    {
+        return;
+    }
+
+    job->cb = cb;
+    job->arg = arg;
+    job->next = NULL;
+    job->queued = 1;
+
+    // Appended so jobs get their first slice in start order
+    task_job_t **link = &s->jobs;
+
+    while (*link != NULL)
+    {
+        link = &(*link)->next;
+    }
+
+    *link = job;
+}
+
+/**
+ * @brief
+ * Remove a background job, finished or not. Main loop only, also from the job itself.
+ */
+void task_job_cancel(task_job_t *job)
+{
+    task_scheduler_t *s = task_self();
+
+    if ((job == NULL) || !job->queued)
+    {
+        return;
+    }
+
+    for (task_job_t **link = &s->jobs; *link != NULL; link = &(*link)->next)
+    {
+        if (*link == job)
+        {
+            *link = job->next;
+            break;
+        }
+    }
+
+    if (s->job_next == job)
+    {
+        s->job_next = job->next;
+    }
+
+    job->queued = 0;
+}
+
+/**
+ * @brief
+ * Returns 1 when background work should return to task_handler(): a task is pending,
+ * or the next release is at most TASK_CFG_IDLE_GUARD ticks away. O(1), poll it often.
+ */
+uint8_t task_should_yield(void)
+{
+    task_scheduler_t *s = task_self();
+
+    if (task_pending())
+    {
+        return 1;
+    }
+
+    return ((s->tick_count - s->idle_from) + TASK_CFG_IDLE_GUARD) >= s->idle_next;
+}
+#endif
+
+#if (TASK_CFG_LOAD != 0)
+/**
+ * @brief
+ * CPU time since task_load_reset(). Call at least once per 2^32 cycles, from the main loop.
+ */
+void task_get_load(task_load_t *load)
+{
+    task_scheduler_t *s = task_self();
+    uint32_t now = TASK_PORT_CYCLES();
+
+    if (load == NULL)
+    {
+        return;
+    }
+
+    s->load.total_cycles += now - s->load_last;
+    s->load_last = now;
+    s->load.busy_cycles = 0;
+
+    for (task_tcb_t *task = s->active; task != NULL; task = task->next)
+    {
+        s->load.busy_cycles += task->busy_cycles;
+    }
+
+    *load = s->load;
+}
+
+/**
+ * @brief
+ * Start a new load window: clear the overall and the per-task times.
+ */
+void task_load_reset(void)
+{
+    task_scheduler_t *s = task_self();
+
+    s->load.total_cycles = 0;
+    s->load.busy_cycles = 0;
+    s->load.background_cycles = 0;
+    s->load.idle_cycles = 0;
+    s->load_last = TASK_PORT_CYCLES();
+
+    for (task_tcb_t *task = s->active; task != NULL; task = task->next)
+    {
+        task->busy_cycles = 0;
+    }
+}
+#endif
+
+#if (TASK_CFG_TRACE != 0)
+/**
+ * @brief
+ * Start tracing the calling core into `buffer`, `capacity` events (rounded down to a
+ * power of two). When full, new events overwrite the oldest. A NULL buffer stops it.
+ */
+void task_trace_init(task_trace_event_t *buffer, uint32_t capacity)
+{
+    task_scheduler_t *s = task_self();
+
+    while ((capacity & (capacity - 1U)) != 0U)
+    {
+        capacity &= capacity - 1U;
+    }
+
+    TASK_ENTER_CRITICAL();
+
+    s->trace = (capacity != 0U) ? buffer : NULL;
+    s->trace_mask = capacity - 1U;
+    s->trace_head = 0;
+    s->trace_tail = 0;
+
+    TASK_EXIT_CRITICAL();
+}
+
+/**
+ * @brief
+ * Copy up to `max` unread events, oldest first, for streaming from the main loop
+ * (UART, RTT, a file). Returns the number copied; `lost` (optional) receives the
+ * events that were overwritten before they could be read.
+ */
+uint32_t task_trace_read(task_trace_event_t *out, uint32_t max, uint32_t *lost)
+{
+    task_scheduler_t *s = task_self();
+    uint32_t count = 0;
+    uint32_t skipped = 0;
+
+    while (count < max)
+    {
+        uint8_t taken = 0;
+
+        // One event per critical section: a trace write never waits for a long copy
+        TASK_ENTER_CRITICAL();
+
+        if ((s->trace != NULL) && (s->trace_head != s->trace_tail))
+        {
+            if ((s->trace_head - s->trace_tail) > (s->trace_mask + 1U))
+            {
+                skipped += s->trace_head - s->trace_tail - (s->trace_mask + 1U);
+                s->trace_tail = s->trace_head - (s->trace_mask + 1U);
+            }
+
+            out[count] = s->trace[s->trace_tail & s->trace_mask];
+            s->trace_tail++;
+            taken = 1;
+        }
+
+        TASK_EXIT_CRITICAL();
+
+        if (!taken)
+        {
+            break;
+        }
+
+        count++;
+    }
+
+    if (lost != NULL)
+    {
+        *lost = skipped;
+    }
+
+    return count;
+}
+#endif
+
+#if (TASK_CFG_BUDGET != 0)
+/**
+ * @brief
+ * Limit the run time of a scheduled task to `ticks` ticks (0 = unlimited). The check
+ * has a resolution of one tick: it fires on the tick that completes the budget.
+ */
+void task_set_budget(task_tcb_t *task, uint32_t ticks)
+{
+    if (task == NULL)
+    {
+        return;
+    }
+
+    task->budget = ticks;
+}
+
+/**
+ * @brief
+ * Register the function called from task_tick() when a handler exceeds its budget,
+ * once per run, with the task and the ticks it has been running. NULL removes it.
+ * The hook runs in interrupt context while the offending handler is still in progress.
+ */
+void task_register_budget_hook(task_budget_hook_t hook)
+{
+    task_self()->budget_hook = hook;
+}
+#endif
+
+#if (TASK_CFG_STATS != 0)
+/**
+ * @brief
+ * Clear the execution statistics and the overflow counter of a task.
+ */
+void task_reset_stats(task_tcb_t *task)
+{
+    task_stats_t cleared = {0};
+
+    task->stats = cleared;
+    task->overflow_count = 0;
 }
+#endif
@@ -15,17 +15,55 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
+#include "task_config.h"
 
 /* Macros --------------------------------------------------------------------*/
 #ifndef NULL
 #define NULL ((void *)0)
 #endif
 
+// Tick rate; conversions to ticks round to the nearest tick and are constant expressions
+#define TASK_TICK_HZ            (TASK_CFG_TICK_HZ)
+#define TASK_TICK_NS            (1000000000UL / TASK_CFG_TICK_HZ)
+#define TASK_US_TO_TICKS(us)    ((uint32_t)((((uint64_t)(us) * TASK_CFG_TICK_HZ) + 500000ULL) / 1000000ULL))
+#define TASK_MS_TO_TICKS(ms)    ((uint32_t)((((uint64_t)(ms) * TASK_CFG_TICK_HZ) + 500ULL) / 1000ULL))
+#define TASK_HZ_TO_TICKS(hz)    ((uint32_t)((TASK_CFG_TICK_HZ + ((hz) / 2U)) / (hz)))
+
+// task_ticks_to_next() result when no task is scheduled
+#define TASK_TICKS_NEVER    (0xFFFFFFFFUL)
+
+// task_schedule_load() flag: the walk covered less than one hyperperiod
+#define TASK_LOAD_TRUNCATED (0x8000U)
+
+// task_set_affinity(): run only on the registering core, or on any core through task_steal()
+#define TASK_AFFINITY_PINNED (0U)
+#define TASK_AFFINITY_ANY    (1U)
+
 /* Types ---------------------------------------------------------------------*/
 
 // Callback function type
 typedef void (*task_handler_cb_t)(void);
 
+// Callback with the context given at registration (TASK_CFG_HANDLER_CTX)
+typedef void (*task_handler_ctx_cb_t)(void *ctx);
+
+// Callback of a sliced task with the slice due, 0..slices-1 (TASK_CFG_SLICES)
+typedef void (*task_slice_cb_t)(uint16_t slice);
+
+typedef struct task_tcb task_tcb_t;
+
+/**
+ * @brief
+ * Dependency edge of a task chain (TASK_CFG_CHAINS), allocated by the application.
+ * Members are private; see task_chain().
+ */
+typedef struct task_edge task_edge_t;
+struct task_edge
+{
+    task_edge_t *next;                // Next successor edge of the same predecessor
+    task_tcb_t *to;                   // Stage run after the predecessor
+};
+
 // Task types
 typedef enum
 {
@@ -41,11 +79,492 @@ typedef enum
     TASK_COUNT
 } task_type_t;
 
+// Budget overrun hook, called from task_tick() with the handler still running
+typedef void (*task_budget_hook_t)(task_tcb_t *task, uint32_t elapsed_ticks);
+
+// Event callback, runs from task_handler() with the argument given to task_queue_post()
+typedef void (*task_event_cb_t)(uintptr_t arg);
+
+/**
+ * @brief
+ * One deferred work item of an event queue.
+ */
+typedef struct
+{
+    task_event_cb_t cb;
+    uintptr_t arg;
+} task_event_t;
+
+/**
+ * @brief
+ * Single-producer / single-consumer event ring (TASK_CFG_EVENTS). The posting
+ * interrupt only writes `head`, task_handler() only writes `tail`, so neither
+ * side needs a lock or an atomic read-modify-write. Members are private.
+ */
+typedef struct task_queue task_queue_t;
+struct task_queue
+{
+    task_queue_t *next;               // Attached queues of the scheduler
+    task_event_t *slots;              // Storage, capacity entries
+    uint16_t mask;                    // Capacity - 1 (capacity is a power of two)
+    volatile uint16_t head;           // Next slot to fill (producer)
+    volatile uint16_t tail;           // Next slot to run (consumer)
+    uint32_t dropped;                 // Posts rejected because the ring was full
+};
+
+// Timer callback, runs from task_handler() with the argument given to task_timer_init()
+typedef void (*task_timer_cb_t)(uintptr_t arg);
+
+/**
+ * @brief
+ * One-shot timer node (TASK_CFG_TIMERS), allocated by the application and linked
+ * into the timing wheel while armed. Members are private.
+ */
+typedef struct task_timer task_timer_t;
+struct task_timer
+{
+    task_timer_t *next;               // Wheel slot or expired list link
+    task_timer_t **pprev;             // Link pointing at this node, NULL while idle
+    uint32_t expires;                 // Absolute tick of expiry
+    task_timer_cb_t cb;
+    uintptr_t arg;
+};
+
+// Idle hook, called from task_handler() when nothing is pending (TASK_CFG_IDLE)
+typedef void (*task_idle_hook_t)(void);
+
+// Background job slice: do a bounded piece of work, return 0 when finished, non-zero to be called again
+typedef uint8_t (*task_job_cb_t)(uintptr_t arg);
+
+/**
+ * @brief
+ * Background job (TASK_CFG_IDLE), allocated by the application. Members are private.
+ */
+typedef struct task_job task_job_t;
+struct task_job
+{
+    task_job_t *next;                 // Job list link
+    task_job_cb_t cb;
+    uintptr_t arg;
+    uint8_t queued;                   // In the job list
+};
+
+/**
+ * @brief
+ * CPU time in TASK_PORT_CYCLES() units since task_load_reset() (TASK_CFG_LOAD).
+ * Load = 1 - idle_cycles / total_cycles; handler time includes handlers they preempt.
+ */
+typedef struct
+{
+    uint64_t total_cycles;            // Length of the window
+    uint64_t busy_cycles;             // Periodic task handlers, all tasks
+    uint64_t background_cycles;       // Background job slices
+    uint64_t idle_cycles;             // Idle hook
+} task_load_t;
+
+// Trace event types (TASK_CFG_TRACE)
+typedef enum
+{
+    TASK_TRACE_RELEASE = 0,           // Released by task_tick()
+    TASK_TRACE_START,                 // Handler entered
+    TASK_TRACE_END,                   // Handler returned
+    TASK_TRACE_OVERFLOW               // Release lost (one event per detection, may cover several)
+} task_trace_type_t;
+
+/**
+ * @brief
+ * Trace record, 8 bytes, stored and streamed as is (little endian on Cortex-M).
+ */
+typedef struct
+{
+    uint32_t time;                    // TASK_PORT_CYCLES() stamp
+    uint16_t task;                    // Task index: built-in frequency 0..TASK_COUNT-1, then the pool
+    uint8_t type;                     // task_trace_type_t, with the instance owning `task` above it
+    uint8_t core;                     // Core that recorded the event (ran the handler)
+} task_trace_event_t;
+
+// Fields of task_trace_event_t.type: the event, and the instance owning the task index
+#define TASK_TRACE_TYPE_MASK    (0x0FU)
+#define TASK_TRACE_OWNER_SHIFT  (4U)
+
+/**
+ * @brief
+ * Criticality of a task for load shedding (TASK_CFG_SHED). Under sustained overload
+ * low tasks are shed first, medium ones next; high tasks keep their rate.
+ */
+typedef enum
+{
+    TASK_CRIT_LOW = 0,                // Halved at shed level 1, suspended from level 2
+    TASK_CRIT_MEDIUM,                 // Halved at shed level 3, suspended at level 4
+    TASK_CRIT_HIGH                    // Never shed (default)
+} task_criticality_t;
+
+/**
+ * @brief
+ * What happens to releases that arrive before the previous one has run (TASK_CFG_OVERRUN).
+ * Every such release is still counted in the overflow counter.
+ */
+typedef enum
+{
+    TASK_OVERRUN_COALESCE = 0,        // Piled up releases run once (default)
+    TASK_OVERRUN_CATCHUP,             // Every release runs, up to TASK_CFG_CATCHUP_BURST back to back
+    TASK_OVERRUN_SKIP                 // Releases during a run are dropped, the task stays on its grid
+} task_overrun_t;
+
+/**
+ * @brief
+ * Per-task execution statistics (TASK_CFG_STATS). Times are in TASK_PORT_CYCLES()
+ * units. Histogram bucket 0 holds values below 2^TASK_CFG_STATS_HIST_SHIFT, bucket
+ * b > 0 holds [2^(shift + b - 1), 2^(shift + b)), the last bucket everything above.
+ */
+typedef struct
+{
+    uint32_t runs;                                      // Completed executions
+    uint32_t exec_min;                                  // Handler execution time
+    uint32_t exec_max;
+    uint64_t exec_sum;                                  // Average = exec_sum / runs
+    uint32_t latency_min;                               // Release to handler start
+    uint32_t latency_max;
+    uint64_t latency_sum;                               // Average = latency_sum / runs
+    uint32_t exec_hist[TASK_CFG_STATS_BUCKETS];
+    uint32_t latency_hist[TASK_CFG_STATS_BUCKETS];
+} task_stats_t;
+
+/**
+ * @brief
+ * Schedulability report of task_analyze() / task_admit() (TASK_CFG_ANALYSIS). Times
+ * are in TASK_PORT_CYCLES() units, utilisations in parts per million of the CPU.
+ */
+typedef struct
+{
+    uint16_t tasks;                   // Periodic tasks analysed, their chain stages included
+    uint16_t unmeasured;              // Tasks without a declared or measured execution time
+    uint16_t misses;                  // Tasks whose response bound exceeds their period
+    uint32_t utilisation;             // Sum of execution time / period
+    uint32_t bound;                   // Liu & Layland bound of preemptive RM, for comparison only; 100% under EDF
+    task_tcb_t *critical;             // Task with the least slack, NULL if none or the candidate
+    int64_t slack;                    // Its period minus its bound (task_get_response_time()), negative if it misses
+} task_analysis_t;
+
+/**
+ * @brief
+ * Task control block. One per scheduled task; the fixed frequencies above use
+ * built-in blocks, additional tasks come from the pool passed to task_pool_init().
+ * Members are private to the scheduler.
+ */
+struct task_tcb
+{
+    task_tcb_t *next;                 // Active list link (free list link while unused)
+    task_handler_cb_t handler;        // Function pointer
+#if (TASK_CFG_HANDLER_CTX != 0)
+    void *ctx;                        // Argument of a context handler
+    uint8_t with_ctx;                 // `handler` holds a task_handler_ctx_cb_t
+#endif
+    uint32_t period;                  // Release period in ticks
+    uint32_t phase;                   // Release offset in ticks (0 <= phase < period)
+#if (TASK_CFG_SLICES != 0)
+    uint16_t slices;                  // Releases per period, 0 = one, plain handler
+    volatile uint16_t slice;          // Slice of the latest release
+#endif
+#if (TASK_CFG_ENGINE == TASK_ENGINE_HEAP)
+    uint32_t due;                     // Absolute tick of the next release
+    uint16_t heap_slot;               // Position in the release heap
+#else
+    uint32_t countdown;               // Ticks left until the next release
+#endif
+    uint16_t index;                   // Slot in the ready mask
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+    uint8_t priority;                 // Ready level, 0 = most urgent
+#elif (TASK_CFG_DISPATCH == TASK_DISPATCH_EDF)
+    uint32_t deadline;                // Absolute tick the pending release is due by
+#endif
+    volatile uint8_t flag;            // Execution flag
+#if (TASK_CFG_OVERRUN != 0)
+    uint8_t overrun;                  // task_overrun_t
+    volatile uint8_t busy;            // Handler is executing
+    volatile uint32_t releases;       // Releases so far (written by task_tick() only)
+    uint32_t served;                  // Releases run so far (written by the dispatcher only)
+#endif
+#if (TASK_CFG_CORES > 1)
+    uint8_t core;                     // Scheduler instance the task is registered with
+#endif
+    uint32_t overflow_count;          // Missed deadline counter
+#if (TASK_CFG_CHAINS != 0)
+    task_edge_t *succ;                // Successor edges
+    task_tcb_t *chain_next;           // Run queue link while its chain executes
+    uint8_t stage;                    // Released by its predecessors, not by the tick
+    uint8_t deps;                     // Number of predecessors
+    uint8_t waiting;                  // Predecessors still to finish in this pass
+#endif
+#if (TASK_CFG_RETUNE != 0)
+    volatile uint32_t period_req;     // Period from the next release on (task_set_period())
+    volatile uint8_t suspended;       // Releases are dropped until task_resume()
+#endif
+#if (TASK_CFG_SHED != 0)
+    uint32_t nominal;                 // Period without shedding
+    uint32_t shed_count;              // Nominal releases lost to shedding (task_get_shed_count())
+    uint8_t criticality;              // task_criticality_t
+    volatile uint8_t shed;            // Degradation applied to this task
+#endif
+#if (TASK_CFG_BUDGET != 0)
+    uint32_t budget;                  // Execution budget in ticks, 0 = unlimited
+    uint32_t run_start;               // Tick the running handler started on
+    volatile uint8_t budget_done;     // No run to check: idle, or overrun already reported
+    task_tcb_t *outer;                // Handler this run preempted
+    uint32_t budget_overruns;         // Runs that exceeded the budget
+#endif
+#if (TASK_CFG_LOAD != 0)
+    uint64_t busy_cycles;             // Handler time since task_load_reset()
+#endif
+#if (TASK_CFG_STATS != 0)
+    uint32_t release_cycles;          // Cycle stamp of the latest release
+    task_stats_t stats;               // Execution statistics
+#endif
+#if (TASK_CFG_ANALYSIS != 0)
+    uint32_t wcet;                    // Declared worst-case execution time, cycles
+    uint64_t response;                // Bound of the latest task_analyze(), cycles (task_get_response_time())
+#endif
+};
+
 /* Function Prototypes -------------------------------------------------------*/
 void task_tick(void);
+void task_tick_n(uint32_t ticks);
 void task_handler(void);
+uint8_t task_handler_one(void);
+#if (TASK_CFG_HOST_WORKERS > 0)
+uint8_t task_handler_shared(void);
+#endif
+uint8_t task_pending(void);
 void task_register_handler(task_type_t task_type, task_handler_cb_t handler);
 
+// Dynamic tasks
+void task_pool_init(task_tcb_t *pool, uint16_t count);
+task_tcb_t *task_add(uint32_t period, uint32_t phase, task_handler_cb_t handler);
+void task_remove(task_tcb_t *task);
+#if (TASK_CFG_HANDLER_CTX != 0)
+void task_register_handler_ctx(task_type_t task_type, task_handler_ctx_cb_t handler, void *ctx);
+task_tcb_t *task_add_ctx(uint32_t period, uint32_t phase, task_handler_ctx_cb_t handler, void *ctx);
+#endif
+#if (TASK_CFG_OVERRUN != 0)
+void task_set_overrun(task_tcb_t *task, task_overrun_t policy);
+#endif
+
+#if (TASK_CFG_SLICES != 0)
+task_tcb_t *task_add_sliced(uint32_t period, uint32_t phase, uint16_t slices, task_slice_cb_t handler);
+#endif
+
+#if (TASK_CFG_CHAINS != 0)
+// Pipelines
+task_tcb_t *task_add_stage(task_handler_cb_t handler);
+#if (TASK_CFG_HANDLER_CTX != 0)
+task_tcb_t *task_add_stage_ctx(task_handler_ctx_cb_t handler, void *ctx);
+#endif
+uint8_t task_chain(task_tcb_t *before, task_tcb_t *after, task_edge_t *edge);
+#endif
+
+#if (TASK_CFG_DISPATCH == TASK_DISPATCH_RM)
+void task_set_priority(task_tcb_t *task, uint8_t priority);
+#endif
+#if (TASK_CFG_PREEMPT_LEVELS > 0)
+void task_preempt_dispatch(uint8_t level);
+#endif
+
+#if (TASK_CFG_CORES > 1)
+// Multi-core work sharing
+void task_set_affinity(task_tcb_t *task, uint8_t affinity);
+uint8_t task_steal(void);
+#endif
+
+#if (TASK_CFG_EVENTS != 0)
+// Deferred work from interrupts
+void task_queue_init(task_queue_t *queue, task_event_t *slots, uint16_t capacity);
+void task_queue_attach(task_queue_t *queue);
+uint8_t task_queue_post(task_queue_t *queue, task_event_cb_t cb, uintptr_t arg);
+#endif
+
+#if (TASK_CFG_TIMERS != 0)
+// One-shot timers
+void task_timer_init(task_timer_t *timer, task_timer_cb_t cb, uintptr_t arg);
+void task_timer_start(task_timer_t *timer, uint32_t ticks);
+void task_timer_cancel(task_timer_t *timer);
+#endif
+
+#if (TASK_CFG_RETUNE != 0)
+// Runtime retuning, interrupt safe
+void task_set_period(task_tcb_t *task, uint32_t period);
+void task_suspend(task_tcb_t *task);
+void task_resume(task_tcb_t *task);
+#endif
+#if (TASK_CFG_SHED != 0)
+void task_set_criticality(task_tcb_t *task, task_criticality_t criticality);
+uint8_t task_get_shed_level(void);
+uint32_t task_get_shed_count(const task_tcb_t *task);
+#endif
+
+// Release phasing
+void task_set_phase(task_tcb_t *task, uint32_t phase);
+void task_stagger(void);
+uint32_t task_hyperperiod(void);
+uint16_t task_schedule_load(uint32_t horizon, uint32_t *worst_tick);
+
+#if (TASK_CFG_ANALYSIS != 0)
+// Schedulability analysis
+void task_set_wcet(task_tcb_t *task, uint32_t cycles);
+uint8_t task_analyze(task_analysis_t *report);
+uint8_t task_admit(uint32_t period, uint32_t wcet, task_analysis_t *report);
+#endif
+
+// Tickless operation
+uint32_t task_ticks_to_next(void);
+void task_advance(uint32_t ticks);
+
+// Time base
+uint32_t task_now(void);
+uint64_t task_time(void);
+uint64_t task_time_us(void);
+
+#if (TASK_CFG_IDLE != 0)
+// Idle time
+void task_register_idle_hook(task_idle_hook_t hook);
+void task_job_start(task_job_t *job, task_job_cb_t cb, uintptr_t arg);
+void task_job_cancel(task_job_t *job);
+uint8_t task_should_yield(void);
+#endif
+#if (TASK_CFG_LOAD != 0)
+void task_get_load(task_load_t *load);
+void task_load_reset(void);
+#endif
+
+// Monitoring
+task_tcb_t *task_get(task_type_t task_type);
+#if (TASK_CFG_TRACE != 0)
+void task_trace_init(task_trace_event_t *buffer, uint32_t capacity);
+uint32_t task_trace_read(task_trace_event_t *out, uint32_t max, uint32_t *lost);
+#endif
+#if (TASK_CFG_BUDGET != 0)
+void task_set_budget(task_tcb_t *task, uint32_t ticks);
+void task_register_budget_hook(task_budget_hook_t hook);
+#endif
+#if (TASK_CFG_STATS != 0)
+void task_reset_stats(task_tcb_t *task);
+#endif
+
+/* Inline Functions ----------------------------------------------------------*/
+
+/**
+ * @brief
+ * Ticks elapsed since an earlier task_now() reading, correct across the 32-bit wrap.
+ */
+static inline uint32_t task_elapsed(uint32_t since)
+{
+    return task_now() - since;
+}
+
+/**
+ * @brief
+ * Releases that were lost because the previous one had not been handled yet.
+ */
+static inline uint32_t task_get_overflow_count(const task_tcb_t *task)
+{
+    return task->overflow_count;
+}
+
+#if (TASK_CFG_RETUNE != 0)
+/**
+ * @brief
+ * Returns 1 while a task is suspended.
+ */
+static inline uint8_t task_is_suspended(const task_tcb_t *task)
+{
+    return task->suspended;
+}
+#endif
+
+#if (TASK_CFG_LOAD != 0)
+/**
+ * @brief
+ * Handler time of a task since task_load_reset(), in TASK_PORT_CYCLES() units.
+ */
+static inline uint64_t task_get_busy_cycles(const task_tcb_t *task)
+{
+    return task->busy_cycles;
+}
+#endif
+
+#if (TASK_CFG_TIMERS != 0)
+/**
+ * @brief
+ * Returns 1 while a timer is armed or expired with its callback not yet run.
+ */
+static inline uint8_t task_timer_active(const task_timer_t *timer)
+{
+    return timer->pprev != NULL;
+}
+#endif
+
+#if (TASK_CFG_EVENTS != 0)
+/**
+ * @brief
+ * Events that could not be posted because the queue was full.
+ */
+static inline uint32_t task_queue_get_dropped(const task_queue_t *queue)
+{
+    return queue->dropped;
+}
+#endif
+
+#if (TASK_CFG_BUDGET != 0)
+/**
+ * @brief
+ * Handler runs that exceeded the execution budget of the task.
+ */
+static inline uint32_t task_get_budget_overruns(const task_tcb_t *task)
+{
+    return task->budget_overruns;
+}
+#endif
+
+#if (TASK_CFG_OVERRUN != 0)
+/**
+ * @brief
+ * Releases of a TASK_OVERRUN_CATCHUP task that are still waiting to run.
+ */
+static inline uint32_t task_get_backlog(const task_tcb_t *task)
+{
+    return (task->overrun == TASK_OVERRUN_CATCHUP) ? (task->releases - task->served) : 0U;
+}
+#endif
+
+/**
+ * @brief
+ * Execution statistics of a task, or NULL when TASK_CFG_STATS is disabled.
+ * Updated by task_handler(); read from the main loop for a consistent snapshot.
+ */
+static inline const task_stats_t *task_get_stats(const task_tcb_t *task)
+{
+#if (TASK_CFG_STATS != 0)
+    return &task->stats;
+#else
+    (void)task;
+    return NULL;
+#endif
+}
+
+#if (TASK_CFG_ANALYSIS != 0)
+/**
+ * @brief
+ * Worst-case response time of a task found by the latest task_analyze(), in cycles
+ * from its release. Above the task's period the deadline (its next release) may be
+ * missed; the bound then stops growing and only shows by how much at least. Under
+ * EDF it is the demand bound U * T + B of the sufficient test instead: at most the
+ * period means the deadline holds, not that the task finishes that early.
+ */
+static inline uint64_t task_get_response_time(const task_tcb_t *task)
+{
+    return task->response;
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
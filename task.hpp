@@ -0,0 +1,331 @@
+/******************************************************************************
+ * File        : task.hpp
+ * Author      : Huseyink
+ * Date        : Oct 14, 2026
+ * Version     : 1.0.0
+ * Description : Task Frequency Scheduler Compile-Time C++ Front End
+ *
+ * Header-only C++17 alternative to task.c for a fixed task set. The periods,
+ * phases and handlers are template arguments, so the schedule is known to the
+ * compiler:
+ *  - the release pattern of one hyperperiod is computed by constexpr code into
+ *    a const table (flash), one bitmask per tick; task_tick() equivalent is a
+ *    table load plus one atomic fetch-or
+ *  - dispatch is a fold expression over the task pack, fully unrolled, with
+ *    each handler called directly (inlined where its definition is visible)
+ *  - TASK_HPP_EXPORT_C() exposes a schedule under C linkage for mixed projects
+ *  - task::add() / task::register_handler() schedule a callable object on the C
+ *    scheduler by reference through its context pointer (TASK_CFG_HANDLER_CTX)
+ *
+ * Usage:
+ *   static void control(void);
+ *   static void report(void);
+ *
+ *   using app = task::schedule<task::periodic<5, control>,       // 200Hz
+ *                              task::every_hz<1, report>>;       // 1Hz
+ *
+ *   TASK_HPP_EXPORT_C(app, app_tick, app_handler)               // extern "C" void app_tick(void) ...
+ *
+ *   static motor_loop motors[4];                                // callable objects, not copied
+ *   task::add(TASK_US_TO_TICKS(500), 0, motors[0]);
+ *
+ * Limitations:
+ *  - At most 32 tasks per schedule; the hyperperiod must fit TASK_HPP_MAX_TABLE ticks
+ *  - Uses std::atomic on the mask: lock-free on cores with exclusive access
+ *    instructions (Cortex-M3 and up), library emulated elsewhere
+ *
+ ******************************************************************************/
+
+#ifndef TASK_HPP_
+#define TASK_HPP_
+
+/* Includes ------------------------------------------------------------------*/
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include "task.h"
+
+#if (__cplusplus < 201703L) && !(defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L))
+#error "task.hpp: needs C++17"
+#endif
+
+/* Defines/macros ------------------------------------------------------------*/
+
+// Largest hyperperiod (ticks) stored as a release table, one mask per tick
+#ifndef TASK_HPP_MAX_TABLE
+#define TASK_HPP_MAX_TABLE      (4096UL)
+#endif
+
+// Define C entry points `tick_name` and `handler_name` for a schedule type
+#define TASK_HPP_EXPORT_C(Schedule, tick_name, handler_name)   \
+    extern "C" void tick_name(void) { Schedule::tick(); }       \
+    extern "C" void handler_name(void) { Schedule::handler(); }
+
+namespace task
+{
+
+/* Task Description ----------------------------------------------------------*/
+
+/**
+ * @brief
+ * A task released on ticks t where t % Period == Phase, running Handler.
+ */
+template <uint32_t Period, void (*Handler)(void), uint32_t Phase = 0>
+struct periodic
+{
+    static_assert(Period != 0U, "task.hpp: period must be non-zero");
+
+    static constexpr uint32_t period = Period;
+    static constexpr uint32_t phase = Phase % Period;
+
+    static inline void run() { Handler(); }
+};
+
+/**
+ * @brief
+ * A task at a frequency in Hz, on the TASK_CFG_TICK_HZ tick (rounded to whole ticks).
+ */
+template <uint32_t Hz, void (*Handler)(void), uint32_t Phase = 0>
+using every_hz = periodic<TASK_HZ_TO_TICKS((Hz != 0U) ? Hz : 1U), Handler, Phase>;
+
+/* Private Helpers -----------------------------------------------------------*/
+
+namespace detail
+{
+
+constexpr uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while (b != 0U)
+    {
+        uint32_t r = a % b;
+        a = b;
+        b = r;
+    }
+
+    return a;
+}
+
+// Least common multiple of all periods, saturating at 0xFFFFFFFF
+template <typename... Periods>
+constexpr uint32_t lcm(Periods... periods)
+{
+    uint64_t hyper = 1U;
+
+    for (uint32_t period : { periods... })
+    {
+        hyper = (hyper / gcd(static_cast<uint32_t>(hyper), period)) * period;
+
+        if (hyper > 0xFFFFFFFFULL)
+        {
+            return 0xFFFFFFFFUL;
+        }
+    }
+
+    return static_cast<uint32_t>(hyper);
+}
+
+// Smallest unsigned type with one bit per task
+template <std::size_t N>
+using mask_t = std::conditional_t<(N <= 8U), uint8_t, std::conditional_t<(N <= 16U), uint16_t, uint32_t>>;
+
+// Index of the least significant set bit of a non-zero mask
+inline uint8_t ctz(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint8_t>(__builtin_ctz(x));
+#else
+    uint8_t n = 0;
+
+    for (; (x & 1U) == 0U; x >>= 1)
+    {
+        n++;
+    }
+
+    return n;
+#endif
+}
+
+// Release masks of one hyperperiod: bit i of entry t is set when t % period_i == phase_i
+template <typename Mask, uint32_t Hyper, typename... Tasks>
+constexpr std::array<Mask, Hyper> release_table()
+{
+    constexpr uint32_t periods[] = { Tasks::period... };
+    constexpr uint32_t phases[] = { Tasks::phase... };
+    std::array<Mask, Hyper> table {};
+
+    for (uint32_t tick = 0; tick < Hyper; tick++)
+    {
+        for (std::size_t i = 0; i < sizeof...(Tasks); i++)
+        {
+            if ((tick % periods[i]) == phases[i])
+            {
+                table[tick] = static_cast<Mask>(table[tick] | (1UL << i));
+            }
+        }
+    }
+
+    return table;
+}
+
+// Largest number of bits set in any entry of a release table
+template <typename Mask, std::size_t Hyper>
+constexpr uint16_t worst_load(const std::array<Mask, Hyper> &table)
+{
+    uint16_t worst = 0;
+
+    for (Mask due : table)
+    {
+        uint16_t load = 0;
+
+        for (; due != 0U; due = static_cast<Mask>(due & (due - 1U)))
+        {
+            load++;
+        }
+
+        worst = (load > worst) ? load : worst;
+    }
+
+    return worst;
+}
+
+#if (TASK_CFG_HANDLER_CTX != 0)
+// Context handler calling the object the context points to
+template <typename F>
+void invoke(void *ctx)
+{
+    (*static_cast<F *>(ctx))();
+}
+#endif
+
+} // namespace detail
+
+/* Runtime Tasks -------------------------------------------------------------*/
+
+#if (TASK_CFG_HANDLER_CTX != 0)
+/**
+ * @brief
+ * task_add_ctx() for a callable object (functor, lambda with captures). The object
+ * is called in place: it is neither copied nor allocated, and must outlive the task.
+ */
+template <typename F>
+inline task_tcb_t *add(uint32_t period, uint32_t phase, F &callable)
+{
+    return task_add_ctx(period, phase, &detail::invoke<F>, &callable);
+}
+
+/**
+ * @brief
+ * task_register_handler_ctx() for a callable object, with the lifetime rule of add().
+ */
+template <typename F>
+inline void register_handler(task_type_t task_type, F &callable)
+{
+    task_register_handler_ctx(task_type, &detail::invoke<F>, &callable);
+}
+
+// A temporary would be destroyed while still scheduled
+template <typename F>
+task_tcb_t *add(uint32_t period, uint32_t phase, F &&callable) = delete;
+
+template <typename F>
+void register_handler(task_type_t task_type, F &&callable) = delete;
+#endif
+
+/* Schedule ------------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Static schedule of the task pack. All members are static; the type is the instance.
+ */
+template <typename... Tasks>
+class schedule
+{
+public:
+    static constexpr std::size_t count = sizeof...(Tasks);
+
+    static_assert(count > 0U, "task.hpp: empty schedule");
+    static_assert(count <= 32U, "task.hpp: at most 32 tasks per schedule");
+
+    using mask_type = detail::mask_t<count>;
+
+    // Ticks after which the release pattern repeats
+    static constexpr uint32_t hyperperiod = detail::lcm(Tasks::period...);
+
+    static_assert(hyperperiod <= TASK_HPP_MAX_TABLE,
+                  "task.hpp: hyperperiod exceeds TASK_HPP_MAX_TABLE, align the periods or raise the limit");
+
+private:
+    template <std::size_t... I>
+    static inline void dispatch(mask_type taken, std::index_sequence<I...>)
+    {
+        // Unrolled in pack order, each handler called directly
+        ((((taken >> I) & 1U) != 0U ? Tasks::run() : void()), ...);
+    }
+
+    static inline uint32_t position = 0;                       // tick % hyperperiod
+    static inline std::atomic<mask_type> ready {0};            // Bit i = task i released
+    static inline uint32_t overflows[count] = {};              // Per-task overflow counters
+
+public:
+    // Released tasks for each tick of the hyperperiod (bit i = i-th task of the pack)
+    static constexpr std::array<mask_type, hyperperiod> release_table =
+        detail::release_table<mask_type, hyperperiod, Tasks...>();
+
+    // Worst-case number of tasks released on the same tick
+    static constexpr uint16_t worst_load = detail::worst_load(release_table);
+
+    /**
+     * @brief
+     * Advance one tick and release the tasks due on it. Call from the tick interrupt.
+     */
+    static inline void tick()
+    {
+        position = (position + 1U == hyperperiod) ? 0U : position + 1U;
+
+        mask_type due = release_table[position];
+
+        if (due != 0U)
+        {
+            // Bits that were still set had not been taken by handler(), overflow occurred
+            mask_type missed = static_cast<mask_type>(ready.fetch_or(due, std::memory_order_acq_rel) & due);
+
+            for (; missed != 0U; missed = static_cast<mask_type>(missed & (missed - 1U)))
+            {
+                overflows[detail::ctz(missed)]++;
+            }
+        }
+    }
+
+    /**
+     * @brief
+     * Run every released task once, in pack order. Call from the main loop.
+     */
+    static inline void handler()
+    {
+        mask_type taken = ready.exchange(0U, std::memory_order_acq_rel);
+
+        if (taken != 0U)
+        {
+            dispatch(taken, std::index_sequence_for<Tasks...>{});
+        }
+    }
+
+    /**
+     * @brief
+     * Releases of task I that were lost because the previous one had not run yet.
+     */
+    template <std::size_t I>
+    static inline uint32_t overflow_count()
+    {
+        static_assert(I < count, "task.hpp: task index out of range");
+
+        return overflows[I];
+    }
+};
+
+} // namespace task
+
+#endif /* TASK_HPP_ */
@@ -0,0 +1,194 @@
+/******************************************************************************
+ * File        : task_clock.c
+ * Author      : Huseyink
+ * Date        : Oct 14, 2026
+ * Version     : 1.0.0
+ * Description : Task Frequency Scheduler Drift-Free Tick Source
+ *
+ * Replaces "call task_tick(), then sleep one period" loops, whose period is the
+ * sleep plus the loop body plus the wake-up latency of the OS. Deadlines are
+ * kept on an absolute monotonic clock; every poll hands all ticks that became
+ * due to task_advance(), so the scheduler time follows the wall clock on
+ * average exactly, and the late and dropped ticks are counted.
+ *
+ * Usage:
+ *  - `task_clock_init()` once, then loop over `task_clock_sleep()`, `task_clock_poll()`, `task_handler()`
+ *  - Read `ticks`, `caught_up`, `lost` and `max_lag_ns` of the task_clock_t for the timing budget
+ *  - Other targets define TASK_CLOCK_NOW_NS() to a 64-bit nanosecond clock; sleeping then polls it
+ *
+ ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "task_clock.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(TASK_CLOCK_NOW_NS)
+#include <errno.h>
+#include <time.h>
+#endif
+
+/* Defines/macros ------------------------------------------------------------*/
+
+#if defined(_WIN32) && !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION   (0x00000002UL)
+#endif
+
+#define TASK_CLOCK_NS_PER_S     (1000000000ULL)
+
+/* Function Definitions ------------------------------------------------------*/
+
+/**
+ * @brief
+ * Current time of the monotonic clock in nanoseconds.
+ */
+uint64_t task_clock_now_ns(void)
+{
+#if defined(TASK_CLOCK_NOW_NS)
+    return TASK_CLOCK_NOW_NS();
+#elif defined(_WIN32)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+
+    if (freq.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&freq);
+    }
+
+    QueryPerformanceCounter(&now);
+
+    // Split to keep count * 1e9 from overflowing
+    uint64_t count = (uint64_t)now.QuadPart;
+    uint64_t hz = (uint64_t)freq.QuadPart;
+
+    return (count / hz) * TASK_CLOCK_NS_PER_S + ((count % hz) * TASK_CLOCK_NS_PER_S) / hz;
+#else
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * TASK_CLOCK_NS_PER_S + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief
+ * Start a tick source with its first deadline one period from now.
+ * `max_burst` bounds the ticks one poll delivers after a long stall (0 = all of them).
+ */
+void task_clock_init(task_clock_t *clk, uint32_t period_ns, uint32_t max_burst)
+{
+    task_clock_t cleared = {0};
+
+    *clk = cleared;
+    clk->period_ns = (period_ns != 0U) ? period_ns : 1U;
+    clk->max_burst = max_burst;
+    clk->next_ns = task_clock_now_ns() + clk->period_ns;
+
+#if defined(_WIN32) && !defined(TASK_CLOCK_NOW_NS)
+    clk->timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+    if (clk->timer == NULL)
+    {
+        // Windows before 10 1803: regular timer, coarser wake-ups but still drift free
+        clk->timer = CreateWaitableTimerW(NULL, FALSE, NULL);
+    }
+#endif
+}
+
+/**
+ * @brief
+ * Release the wait object of a tick source.
+ */
+void task_clock_close(task_clock_t *clk)
+{
+#if defined(_WIN32) && !defined(TASK_CLOCK_NOW_NS)
+    if (clk->timer != NULL)
+    {
+        (void)CloseHandle((HANDLE)clk->timer);
+    }
+#endif
+
+    clk->timer = NULL;
+}
+
+/**
+ * @brief
+ * Block until the deadline of the next tick. Returns at once when it has passed.
+ */
+void task_clock_sleep(task_clock_t *clk)
+{
+#if defined(TASK_CLOCK_NOW_NS)
+    while (task_clock_now_ns() < clk->next_ns)
+    {
+    }
+#elif defined(_WIN32)
+    uint64_t now = task_clock_now_ns();
+
+    if ((now < clk->next_ns) && (clk->timer != NULL))
+    {
+        // Relative due time in 100ns units, recomputed from the absolute deadline every time
+        LARGE_INTEGER due;
+        due.QuadPart = -(LONGLONG)((clk->next_ns - now) / 100U);
+
+        if ((due.QuadPart != 0) && SetWaitableTimer((HANDLE)clk->timer, &due, 0, NULL, NULL, FALSE))
+        {
+            (void)WaitForSingleObject((HANDLE)clk->timer, INFINITE);
+        }
+    }
+#else
+    struct timespec deadline;
+
+    deadline.tv_sec = (time_t)(clk->next_ns / TASK_CLOCK_NS_PER_S);
+    deadline.tv_nsec = (long)(clk->next_ns % TASK_CLOCK_NS_PER_S);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+    {
+    }
+#endif
+}
+
+/**
+ * @brief
+ * Deliver every tick whose deadline has passed to the scheduler through task_advance().
+ * Call from the context that would otherwise call task_tick(). Returns the ticks delivered.
+ */
+uint32_t task_clock_poll(task_clock_t *clk)
+{
+    uint64_t now = task_clock_now_ns();
+
+    if (now < clk->next_ns)
+    {
+        return 0;
+    }
+
+    uint64_t lag = now - clk->next_ns;
+    uint64_t due = lag / clk->period_ns + 1U;
+    uint64_t deliver = due;
+
+    if (lag > clk->max_lag_ns)
+    {
+        clk->max_lag_ns = lag;
+    }
+
+    uint64_t limit = (clk->max_burst != 0U) ? clk->max_burst : 0xFFFFFFFFULL;
+
+    if (deliver > limit)
+    {
+        // Too far behind: keep the deadlines on the wall clock and drop the excess ticks
+        deliver = limit;
+        clk->lost += (uint32_t)(due - deliver);
+    }
+
+    clk->next_ns += due * clk->period_ns;
+    clk->ticks += (uint32_t)deliver;
+    clk->caught_up += (uint32_t)(deliver - 1U);
+
+    task_advance((uint32_t)deliver);
+
+    return (uint32_t)deliver;
+}
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * File        : task_clock.h
+ * Author      : Huseyink
+ * Date        : Oct 14, 2026
+ * Version     : 1.0.0
+ * Description : Task Frequency Scheduler Drift-Free Tick Source
+ ******************************************************************************/
+
+#ifndef TASK_CLOCK_H_
+#define TASK_CLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "task.h"
+
+/* Types ---------------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Tick source driven by an absolute monotonic clock. The deadline of tick n is
+ * start + n * period, so late wake-ups are made up instead of accumulating.
+ * The counters are read-only for the application.
+ */
+typedef struct
+{
+    uint64_t next_ns;                 // Absolute deadline of the next tick
+    uint64_t period_ns;               // Tick period
+    uint32_t max_burst;               // Ticks delivered per poll at most, 0 = unbounded
+    uint32_t ticks;                   // Ticks delivered to the scheduler
+    uint32_t caught_up;               // Ticks delivered late, in a burst after the first
+    uint32_t lost;                    // Ticks dropped beyond max_burst
+    uint64_t max_lag_ns;              // Worst delay of a tick behind its deadline
+    void *timer;                      // Wait object of the host (Windows), NULL elsewhere
+} task_clock_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+void task_clock_init(task_clock_t *clk, uint32_t period_ns, uint32_t max_burst);
+void task_clock_close(task_clock_t *clk);
+void task_clock_sleep(task_clock_t *clk);
+uint32_t task_clock_poll(task_clock_t *clk);
+uint64_t task_clock_now_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASK_CLOCK_H_ */
@@ -0,0 +1,525 @@
+/******************************************************************************
+ * File        : task_config.h
+ * Author      : Huseyink
+ * Date        : Oct 14, 2026
+ * Version     : 1.0.0
+ * Description : Task Frequency Scheduler Build Configuration
+ *
+ * Every option below has a default and may be overridden from the compiler
+ * command line (e.g. -DTASK_CFG_ENGINE=TASK_ENGINE_MODULO) or by defining it
+ * before this header is included.
+ ******************************************************************************/
+
+#ifndef TASK_CONFIG_H_
+#define TASK_CONFIG_H_
+
+/* Tick Engines --------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Release detection used inside task_tick().
+ *
+ * TASK_ENGINE_MODULO    : `tick_count % period` per task (one division per task and tick)
+ * TASK_ENGINE_COUNTDOWN : per-task countdown, decrement + zero test only (no division)
+ * TASK_ENGINE_HEAP      : min-heap keyed on the next release tick; a tick only touches
+ *                         the tasks that are due, O(log N) each (for large task counts)
+ */
+#define TASK_ENGINE_MODULO      (0)
+#define TASK_ENGINE_COUNTDOWN   (1)
+#define TASK_ENGINE_HEAP        (2)
+
+#ifndef TASK_CFG_ENGINE
+#define TASK_CFG_ENGINE         TASK_ENGINE_COUNTDOWN
+#endif
+
+#if (TASK_CFG_ENGINE != TASK_ENGINE_MODULO) && (TASK_CFG_ENGINE != TASK_ENGINE_COUNTDOWN) && \
+    (TASK_CFG_ENGINE != TASK_ENGINE_HEAP)
+#error "task_config.h: unknown TASK_CFG_ENGINE"
+#endif
+
+/* Task Table ----------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Upper bound on scheduled tasks: the TASK_COUNT built-in frequencies plus the
+ * dynamic tasks of the pool given to task_pool_init(). Sizes the ready mask.
+ */
+#ifndef TASK_CFG_MAX_TASKS
+#define TASK_CFG_MAX_TASKS      (32)
+#endif
+
+/* Tick Rate -----------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Frequency of task_tick() calls in Hz. The built-in frequencies need a multiple
+ * of 200 (1kHz default, 10kHz for a 100us tick); dynamic task periods can be given
+ * in time units through TASK_US_TO_TICKS() and friends in task.h.
+ */
+#ifndef TASK_CFG_TICK_HZ
+#define TASK_CFG_TICK_HZ        (1000UL)
+#endif
+
+#if (TASK_CFG_TICK_HZ < 200) || ((TASK_CFG_TICK_HZ % 200) != 0)
+#error "task_config.h: TASK_CFG_TICK_HZ must be a multiple of 200 for the built-in frequencies"
+#endif
+
+/* Handler Context ---------------------------------------------------------*/
+
+/**
+ * @brief
+ * Handlers taking a `void *` context (task_add_ctx(), task_register_handler_ctx()),
+ * so one handler body serves many task instances without per-instance globals or
+ * trampolines. Costs a pointer and a byte per task and one test per handler run.
+ */
+#ifndef TASK_CFG_HANDLER_CTX
+#define TASK_CFG_HANDLER_CTX    (0)
+#endif
+
+/* Sliced Tasks --------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Tasks whose work is split into N slices spread evenly over the ticks of their
+ * period (task_add_sliced()); the handler gets the slice index.
+ */
+#ifndef TASK_CFG_SLICES
+#define TASK_CFG_SLICES         (0)
+#endif
+
+/* Task Chains ---------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Pipeline stages (task_add_stage()) that run right after their predecessors
+ * (task_chain()), in the same task_handler() pass, in topological order. With
+ * several host workers, independent branches run on other workers in parallel.
+ */
+#ifndef TASK_CFG_CHAINS
+#define TASK_CFG_CHAINS         (0)
+#endif
+
+/* Ready Handoff -------------------------------------------------------------*/
+
+/**
+ * @brief
+ * How task_tick() hands released tasks to task_handler().
+ *
+ * 0 : one volatile byte flag per task, polled and cleared by task_handler()
+ * 1 : one atomic bitmask; task_tick() sets bits with a single fetch-or,
+ *     task_handler() takes every pending task with a single exchange and
+ *     walks the set bits (see TASK_ATOMIC_* and TASK_CTZ in task_port.h)
+ */
+#ifndef TASK_CFG_READY_MASK
+#define TASK_CFG_READY_MASK     (0)
+#endif
+
+/* Dispatch Order ------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Order in which task_handler() / task_handler_one() run pending tasks.
+ *
+ * TASK_DISPATCH_INDEX : task index order, built-in 1Hz first (original behaviour)
+ * TASK_DISPATCH_RM    : rate monotonic, shortest period first. Each task gets a priority
+ *                       level (floor(log2(period)), see task_set_priority()); the most urgent
+ *                       level is found with one CTZ on a level bitmask
+ * TASK_DISPATCH_EDF   : earliest deadline first, deadline = release tick + period;
+ *                       selection scans the pending tasks only
+ *
+ * RM and EDF re-select after every handler, need TASK_CFG_READY_MASK and cost
+ * one atomic read-modify-write per release instead of one per tick.
+ */
+#define TASK_DISPATCH_INDEX     (0)
+#define TASK_DISPATCH_RM        (1)
+#define TASK_DISPATCH_EDF       (2)
+
+#ifndef TASK_CFG_DISPATCH
+#define TASK_CFG_DISPATCH       TASK_DISPATCH_INDEX
+#endif
+
+// Rate monotonic priority levels (1..32), level 0 is the most urgent
+#ifndef TASK_CFG_PRIORITY_LEVELS
+#define TASK_CFG_PRIORITY_LEVELS (16)
+#endif
+
+#if (TASK_CFG_DISPATCH != TASK_DISPATCH_INDEX) && (TASK_CFG_READY_MASK == 0)
+#error "task_config.h: TASK_CFG_DISPATCH other than TASK_DISPATCH_INDEX needs TASK_CFG_READY_MASK"
+#endif
+
+#if (TASK_CFG_PRIORITY_LEVELS < 1) || (TASK_CFG_PRIORITY_LEVELS > 32)
+#error "task_config.h: TASK_CFG_PRIORITY_LEVELS must be 1..32"
+#endif
+
+/* Preemptive Execution ------------------------------------------------------*/
+
+/**
+ * @brief
+ * Number of most urgent rate monotonic levels (0..n-1) that run from software
+ * triggered interrupts instead of task_handler(). task_tick() pends the
+ * interrupt of a level through TASK_PORT_PEND(level) when one of its tasks is
+ * released, and that interrupt calls task_preempt_dispatch(level). With the
+ * interrupt priorities descending by level, a 200Hz task preempts a running
+ * 1Hz one on the same stack. 0 keeps every task cooperative.
+ */
+#ifndef TASK_CFG_PREEMPT_LEVELS
+#define TASK_CFG_PREEMPT_LEVELS (0)
+#endif
+
+#if (TASK_CFG_PREEMPT_LEVELS > 0) && (TASK_CFG_DISPATCH != TASK_DISPATCH_RM)
+#error "task_config.h: TASK_CFG_PREEMPT_LEVELS needs TASK_CFG_DISPATCH == TASK_DISPATCH_RM"
+#endif
+
+#if (TASK_CFG_PREEMPT_LEVELS > TASK_CFG_PRIORITY_LEVELS)
+#error "task_config.h: TASK_CFG_PREEMPT_LEVELS exceeds TASK_CFG_PRIORITY_LEVELS"
+#endif
+
+/* Event Queues --------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Deferred work from interrupts: single-producer / single-consumer rings of
+ * callback + argument entries (task_queue_init()), drained by task_handler()
+ * in the same pass as the periodic tasks. One ring per posting interrupt.
+ */
+#ifndef TASK_CFG_EVENTS
+#define TASK_CFG_EVENTS         (0)
+#endif
+
+/* Timers --------------------------------------------------------------------*/
+
+/**
+ * @brief
+ * One-shot timers on a hashed timing wheel (task_timer_start()). Timer nodes are
+ * intrusive and owned by the application; a tick only visits the timers hashed
+ * to its wheel slot, start and cancel are O(1). Callbacks run from task_handler().
+ */
+#ifndef TASK_CFG_TIMERS
+#define TASK_CFG_TIMERS         (0)
+#endif
+
+// Wheel slots (power of two); about the number of concurrently pending timers is a good size
+#ifndef TASK_CFG_TIMER_WHEEL
+#define TASK_CFG_TIMER_WHEEL    (64)
+#endif
+
+#if (TASK_CFG_TIMER_WHEEL < 1) || ((TASK_CFG_TIMER_WHEEL & (TASK_CFG_TIMER_WHEEL - 1)) != 0)
+#error "task_config.h: TASK_CFG_TIMER_WHEEL must be a power of two"
+#endif
+
+/* Overrun Policies ----------------------------------------------------------*/
+
+/**
+ * @brief
+ * Per-task handling of releases that arrive before the previous one has run
+ * (task_set_overrun()). Without it every task coalesces such releases into one
+ * run. Costs two counters and two bytes per task and one store per handler run.
+ */
+#ifndef TASK_CFG_OVERRUN
+#define TASK_CFG_OVERRUN        (0)
+#endif
+
+// Backlogged releases a TASK_OVERRUN_CATCHUP task runs back to back per dispatch
+#ifndef TASK_CFG_CATCHUP_BURST
+#define TASK_CFG_CATCHUP_BURST  (4)
+#endif
+
+#if (TASK_CFG_CATCHUP_BURST < 1)
+#error "task_config.h: TASK_CFG_CATCHUP_BURST must be at least 1"
+#endif
+
+/* Execution Budgets ---------------------------------------------------------*/
+
+/**
+ * @brief
+ * Per-task execution budget in ticks (task_set_budget()). task_tick() checks the
+ * handler in progress and calls the hook of task_register_budget_hook() once per
+ * run that exceeds it, from the tick interrupt, with the task and the elapsed ticks.
+ * Costs one compare per tick and a few stores per handler run.
+ */
+#ifndef TASK_CFG_BUDGET
+#define TASK_CFG_BUDGET         (0)
+#endif
+
+/* Runtime Retuning ----------------------------------------------------------*/
+
+/**
+ * @brief
+ * task_set_period(), task_suspend() and task_resume(): single word requests, safe
+ * from interrupts, that task_tick() applies at the next release of the task. Costs
+ * one compare per release.
+ */
+#ifndef TASK_CFG_RETUNE
+#define TASK_CFG_RETUNE         (0)
+#endif
+
+/* Load Shedding -------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Criticality based degradation under overload. task_tick() counts the overflows
+ * of all tasks per window; a window with TASK_CFG_SHED_THRESHOLD or more steps
+ * the shed level up (low criticality tasks at half rate, then suspended, then
+ * the same for medium), TASK_CFG_SHED_RECOVER windows without overflow step it
+ * back down. High criticality tasks, the default, are never shed.
+ */
+#ifndef TASK_CFG_SHED
+#define TASK_CFG_SHED           (0)
+#endif
+
+// Observation window in ticks
+#ifndef TASK_CFG_SHED_WINDOW
+#define TASK_CFG_SHED_WINDOW    (TASK_CFG_TICK_HZ)
+#endif
+
+// Overflows per window that trigger the next degradation step
+#ifndef TASK_CFG_SHED_THRESHOLD
+#define TASK_CFG_SHED_THRESHOLD (8)
+#endif
+
+// Consecutive windows without overflow before one step is undone
+#ifndef TASK_CFG_SHED_RECOVER
+#define TASK_CFG_SHED_RECOVER   (3)
+#endif
+
+#if (TASK_CFG_SHED != 0) && (TASK_CFG_RETUNE == 0)
+#error "task_config.h: TASK_CFG_SHED needs TASK_CFG_RETUNE"
+#endif
+
+#if (TASK_CFG_SHED != 0) && ((TASK_CFG_SHED_WINDOW < 1) || (TASK_CFG_SHED_THRESHOLD < 1) || (TASK_CFG_SHED_RECOVER < 1) || (TASK_CFG_SHED_RECOVER > 255))
+#error "task_config.h: TASK_CFG_SHED_WINDOW and TASK_CFG_SHED_THRESHOLD must be at least 1, TASK_CFG_SHED_RECOVER 1..255"
+#endif
+
+/* Release Phasing -----------------------------------------------------------*/
+
+/**
+ * @brief
+ * Most ticks task_schedule_load(0, ...) walks when the hyperperiod is longer. Each
+ * tick costs one release test per task; a load found over a shorter walk is flagged
+ * with TASK_LOAD_TRUNCATED.
+ */
+#ifndef TASK_CFG_LOAD_HORIZON
+#define TASK_CFG_LOAD_HORIZON   (1000000UL)
+#endif
+
+#if (TASK_CFG_LOAD_HORIZON < 1)
+#error "task_config.h: TASK_CFG_LOAD_HORIZON must be at least 1"
+#endif
+
+/* Idle Time -----------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Idle-time work in task_handler(): when nothing is pending, background jobs
+ * (task_job_start()) run in slices, round robin, until task_should_yield(), then
+ * the idle hook of task_register_idle_hook() runs (WFI, low-power entry).
+ */
+#ifndef TASK_CFG_IDLE
+#define TASK_CFG_IDLE           (0)
+#endif
+
+// task_should_yield() returns 1 this many ticks before the next release (and whenever one is pending)
+#ifndef TASK_CFG_IDLE_GUARD
+#define TASK_CFG_IDLE_GUARD     (1)
+#endif
+
+/**
+ * @brief
+ * CPU load accounting in TASK_PORT_CYCLES() units: time in handlers per task, in
+ * background jobs and in the idle hook, over a window restarted by task_load_reset().
+ * Costs two cycle counter reads per handler run and per idle pass.
+ */
+#ifndef TASK_CFG_LOAD
+#define TASK_CFG_LOAD           (0)
+#endif
+
+#if (TASK_CFG_LOAD != 0) && (TASK_CFG_IDLE == 0)
+#error "task_config.h: TASK_CFG_LOAD needs TASK_CFG_IDLE"
+#endif
+
+/* Multi-Core ----------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Number of cores running their own scheduler instance. Every core calls
+ * task_tick() from its own timer and task_handler() from its own main loop;
+ * the API works on the instance of the calling core (TASK_PORT_CORE_ID() in
+ * task_port.h), and tasks stay with the core that registered them unless
+ * task_set_affinity() lets an idle core take them over with task_steal().
+ */
+#ifndef TASK_CFG_CORES
+#define TASK_CFG_CORES          (1)
+#endif
+
+#if (TASK_CFG_CORES < 1) || (TASK_CFG_CORES > 255)
+#error "task_config.h: TASK_CFG_CORES must be 1..255"
+#endif
+
+#if (TASK_CFG_CORES > 1) && (TASK_CFG_READY_MASK == 0)
+#error "task_config.h: TASK_CFG_CORES > 1 needs TASK_CFG_READY_MASK"
+#endif
+
+/* Host Backend --------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Number of worker threads of the host backend (task_host.c), 0 when it is not
+ * used. A timer thread calls task_tick() on absolute deadlines every
+ * TASK_CFG_HOST_TICK_NS nanoseconds and the workers run the released handlers
+ * in parallel, taking them from the shared ready mask.
+ */
+#ifndef TASK_CFG_HOST_WORKERS
+#define TASK_CFG_HOST_WORKERS   (0)
+#endif
+
+// Host tick period in nanoseconds
+#ifndef TASK_CFG_HOST_TICK_NS
+#define TASK_CFG_HOST_TICK_NS   (1000000000UL / TASK_CFG_TICK_HZ)
+#endif
+
+#if (TASK_CFG_HOST_WORKERS > 0) && (TASK_CFG_READY_MASK == 0)
+#error "task_config.h: TASK_CFG_HOST_WORKERS needs TASK_CFG_READY_MASK"
+#endif
+
+#if (TASK_CFG_HOST_WORKERS > 0) && (TASK_CFG_CORES > 1)
+#error "task_config.h: TASK_CFG_HOST_WORKERS and TASK_CFG_CORES > 1 are exclusive"
+#endif
+
+/* RTOS Backend --------------------------------------------------------------*/
+
+#define TASK_RTOS_NONE          (0)
+#define TASK_RTOS_FREERTOS      (1)
+#define TASK_RTOS_ZEPHYR        (2)
+
+/**
+ * @brief
+ * Kernel of the RTOS backend (task_rtos.c), TASK_RTOS_NONE when it is not used.
+ * A periodic kernel timer calls task_tick(), each preemptive level
+ * (TASK_CFG_PREEMPT_LEVELS) gets its own thread woken by TASK_PORT_PEND(), and
+ * one background thread below them runs task_handler() for the other levels.
+ */
+#ifndef TASK_CFG_RTOS
+#define TASK_CFG_RTOS           (TASK_RTOS_NONE)
+#endif
+
+/**
+ * @brief
+ * Kernel priority of the level 0 thread. Every further level, then the
+ * background thread, is one step less urgent in the kernel's own numbering:
+ * FreeRTOS counts down toward its idle task (0), Zephyr counts up.
+ */
+#ifndef TASK_CFG_RTOS_PRIORITY
+#if (TASK_CFG_RTOS == TASK_RTOS_FREERTOS)
+#define TASK_CFG_RTOS_PRIORITY  (TASK_CFG_PREEMPT_LEVELS + 1)
+#else
+#define TASK_CFG_RTOS_PRIORITY  (0)
+#endif
+#endif
+
+// Stack size in bytes of each backend thread, taken from one static pool
+#ifndef TASK_CFG_RTOS_STACK
+#define TASK_CFG_RTOS_STACK     (1024)
+#endif
+
+/**
+ * @brief
+ * Stack size in bytes of the thread of preemptive level n; n == TASK_CFG_PREEMPT_LEVELS
+ * is the background thread. Fast levels run short handlers and need much less than it.
+ * E.g. -D'TASK_CFG_RTOS_STACK_LEVEL(n)=(((n) < 2) ? 512 : 2048)'
+ */
+#ifndef TASK_CFG_RTOS_STACK_LEVEL
+#define TASK_CFG_RTOS_STACK_LEVEL(n) (TASK_CFG_RTOS_STACK)
+#endif
+
+#if (TASK_CFG_RTOS != TASK_RTOS_NONE) && (TASK_CFG_RTOS != TASK_RTOS_FREERTOS) && (TASK_CFG_RTOS != TASK_RTOS_ZEPHYR)
+#error "task_config.h: TASK_CFG_RTOS must be TASK_RTOS_NONE, TASK_RTOS_FREERTOS or TASK_RTOS_ZEPHYR"
+#endif
+
+#if (TASK_CFG_RTOS != TASK_RTOS_NONE) && ((TASK_CFG_HOST_WORKERS > 0) || (TASK_CFG_CORES > 1))
+#error "task_config.h: TASK_CFG_RTOS excludes TASK_CFG_HOST_WORKERS and TASK_CFG_CORES > 1"
+#endif
+
+#if (TASK_CFG_RTOS == TASK_RTOS_FREERTOS) && (TASK_CFG_RTOS_PRIORITY <= TASK_CFG_PREEMPT_LEVELS)
+#error "task_config.h: TASK_CFG_RTOS_PRIORITY leaves no FreeRTOS priority above idle for the background thread"
+#endif
+
+/* Memory Layout -------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Data cache line size in bytes (32 on Cortex-M7), 0 for parts without a data
+ * cache. When set, the state written by task_tick() and the state written by
+ * the main loop start on separate lines, and every core instance is padded to
+ * whole lines, avoiding false sharing between the ISR, the main loop and cores.
+ * Code and data placement attributes are in task_port.h (TASK_PORT_FAST_*).
+ */
+#ifndef TASK_CFG_CACHE_LINE
+#define TASK_CFG_CACHE_LINE     (0)
+#endif
+
+#if (TASK_CFG_CACHE_LINE < 0) || ((TASK_CFG_CACHE_LINE & (TASK_CFG_CACHE_LINE - 1)) != 0)
+#error "task_config.h: TASK_CFG_CACHE_LINE must be 0 or a power of two"
+#endif
+
+/* Instrumentation -----------------------------------------------------------*/
+
+/**
+ * @brief
+ * Per-task execution time and release-to-start latency statistics with
+ * log2 histograms, timed with TASK_PORT_CYCLES() (see task_port.h).
+ * Costs one cycle counter read per releasing tick and two per handler run.
+ */
+#ifndef TASK_CFG_STATS
+#define TASK_CFG_STATS          (0)
+#endif
+
+// Histogram buckets per measurement
+#ifndef TASK_CFG_STATS_BUCKETS
+#define TASK_CFG_STATS_BUCKETS  (8)
+#endif
+
+// Width of histogram bucket 0 as a power of two (cycles below 2^shift)
+#ifndef TASK_CFG_STATS_HIST_SHIFT
+#define TASK_CFG_STATS_HIST_SHIFT (6)
+#endif
+
+/**
+ * @brief
+ * Schedulability analysis (task_analyze(), task_admit()): response-time bounds of
+ * every task from its period and worst-case execution time, either declared with
+ * task_set_wcet() or the longest run measured by TASK_CFG_STATS. Runs on request
+ * in the main loop (or a host build) and adds nothing to task_tick().
+ */
+#ifndef TASK_CFG_ANALYSIS
+#define TASK_CFG_ANALYSIS       (0)
+#endif
+
+/**
+ * @brief
+ * TASK_PORT_CYCLES() counts per second, relating execution times to periods.
+ * May be a runtime expression such as SystemCoreClock; only the analysis uses it.
+ */
+#if (TASK_CFG_ANALYSIS != 0) && !defined(TASK_CFG_CYCLES_HZ)
+#error "task_config.h: TASK_CFG_ANALYSIS needs TASK_CFG_CYCLES_HZ, the TASK_PORT_CYCLES() rate"
+#endif
+
+/**
+ * @brief
+ * Binary event trace (task_trace_init()): release, handler start / end and overflow
+ * events stamped with TASK_PORT_CYCLES(), written to a RAM ring that overwrites the
+ * oldest entries. An event costs one cycle counter read, a short interrupt-masked
+ * store of 8 bytes and no formatting; tools/task_trace.py decodes the stream.
+ */
+#ifndef TASK_CFG_TRACE
+#define TASK_CFG_TRACE          (0)
+#endif
+
+#if (TASK_CFG_TRACE != 0) && (TASK_CFG_CORES > 16)
+#error "task_config.h: TASK_CFG_TRACE stores the owning core of a task in 4 bits, up to 16 cores"
+#endif
+
+#if (TASK_CFG_TRACE != 0) && (TASK_CFG_HOST_WORKERS > 0)
+#error "task_config.h: TASK_CFG_TRACE records under TASK_ENTER_CRITICAL(), which the host backend holds in task_tick()"
+#endif
+
+#endif /* TASK_CONFIG_H_ */
@@ -0,0 +1,377 @@
+/******************************************************************************
+ * File        : task_host.c
+ * Author      : Huseyink
+ * Date        : Oct 14, 2026
+ * Version     : 1.0.0
+ * Description : Task Frequency Scheduler Host Backend
+ *
+ * Runs the scheduler on Linux and Windows hosts with the application code of
+ * the target. A timer thread replaces the tick interrupt and drives the
+ * scheduler from a task_clock_t (clock_nanosleep with TIMER_ABSTIME, or a high
+ * resolution waitable timer), so sleep latency never accumulates into drift.
+ * TASK_CFG_HOST_WORKERS worker threads take released tasks from the ready mask
+ * and run them in parallel; a slow 1Hz handler occupies one worker while the
+ * others keep serving the 200Hz task. The first worker also wakes on every tick
+ * and calls task_handler_shared(): event queues, timers and the idle pass, then
+ * one task claimed like on the other workers, so no task waits behind it.
+ *
+ * Usage:
+ *  - Build with -DTASK_CFG_READY_MASK=1 -DTASK_CFG_HOST_WORKERS=n (and -pthread)
+ *  - Register tasks, then call `task_host_start()`; `task_host_stop()` joins all threads
+ *  - `task_host_clock()` reports the late and dropped ticks of the timer thread
+ *
+ * Limitations:
+ *  - A handler never runs on two workers at once; a release that arrives while it
+ *    still runs waits for it (and counts as overflow as on the target)
+ *  - Deadlines missed by more than one tick are made up in one task_advance() call
+ *  - Chain stages (TASK_CFG_CHAINS) that become ready together are spread over the
+ *    workers: one continues on the finishing worker, the others wake idle ones
+ *  - Events, timer callbacks, background jobs and the idle hook all run on the
+ *    first worker, between two of its handlers: they wait for the longest handler
+ *    that worker may claim, which can be any task. With one worker also the tasks do
+ *
+ ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "task_host.h"
+#include "task_port.h"
+
+#if (TASK_CFG_HOST_WORKERS > 0)
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/* Defines/macros ------------------------------------------------------------*/
+
+#if defined(_WIN32)
+#define TASK_HOST_THREAD(name)      static DWORD WINAPI name(LPVOID arg)
+#define TASK_HOST_MUTEX_INIT        SRWLOCK_INIT
+#define TASK_HOST_COND_INIT         CONDITION_VARIABLE_INIT
+#define TASK_HOST_MUTEX_LOCK(m)     AcquireSRWLockExclusive(m)
+#define TASK_HOST_MUTEX_UNLOCK(m)   ReleaseSRWLockExclusive(m)
+#define TASK_HOST_COND_WAIT(c, m)   (void)SleepConditionVariableSRW((c), (m), INFINITE, 0)
+#define TASK_HOST_COND_WAKE_ALL(c)  WakeAllConditionVariable(c)
+#else
+#define TASK_HOST_THREAD(name)      static void *name(void *arg)
+#define TASK_HOST_MUTEX_INIT        PTHREAD_MUTEX_INITIALIZER
+#define TASK_HOST_COND_INIT         PTHREAD_COND_INITIALIZER
+#define TASK_HOST_MUTEX_LOCK(m)     (void)pthread_mutex_lock(m)
+#define TASK_HOST_MUTEX_UNLOCK(m)   (void)pthread_mutex_unlock(m)
+#define TASK_HOST_COND_WAIT(c, m)   (void)pthread_cond_wait((c), (m))
+#define TASK_HOST_COND_WAKE_ALL(c)  (void)pthread_cond_broadcast(c)
+#endif
+
+// Claims per worker wake-up, bounds the spin on a release whose handler still runs elsewhere
+#define TASK_HOST_BATCH     (TASK_CFG_MAX_TASKS)
+
+/* Types ---------------------------------------------------------------------*/
+
+#if defined(_WIN32)
+typedef HANDLE task_host_thread_t;
+typedef SRWLOCK task_host_mutex_t;
+typedef CONDITION_VARIABLE task_host_cond_t;
+#else
+typedef pthread_t task_host_thread_t;
+typedef pthread_mutex_t task_host_mutex_t;
+typedef pthread_cond_t task_host_cond_t;
+#endif
+
+/**
+ * @brief Host backend state.
+ */
+typedef struct
+{
+    task_host_thread_t tick_thread;                // Calls task_tick()
+    task_host_thread_t workers[TASK_CFG_HOST_WORKERS]; // Run released handlers
+    uint8_t worker_count;                          // Workers started
+    uint8_t ticking;                               // Tick thread started
+    TASK_ATOMIC_U32 stop;                          // Set by task_host_stop()
+    task_host_mutex_t lock;                        // Scheduler critical section
+    task_host_mutex_t wake_lock;                   // Guards `generation`
+    task_host_cond_t wake;                         // Signalled when a tick released work
+    task_host_cond_t service;                      // Signalled on every tick, for the first worker
+    uint32_t generation;                           // Ticks that released work
+    uint32_t ticks;                                // Ticks delivered, wakes the first worker
+    task_clock_t clock;                            // Tick deadlines and timing budget
+} task_host_t;
+
+/* Private Variables ---------------------------------------------------------*/
+
+static task_host_t host =
+{
+    .lock = TASK_HOST_MUTEX_INIT,
+    .wake_lock = TASK_HOST_MUTEX_INIT,
+    .wake = TASK_HOST_COND_INIT,
+    .service = TASK_HOST_COND_INIT
+};
+
+/* Private Functions ---------------------------------------------------------*/
+
+/**
+ * @brief
+ * Timer thread: the host replacement of the tick interrupt.
+ */
+TASK_HOST_THREAD(task_host_tick_main)
+{
+    (void)arg;
+
+    task_clock_init(&host.clock, TASK_CFG_HOST_TICK_NS, 0);
+
+    while (TASK_ATOMIC_LOAD(&host.stop) == 0U)
+    {
+        task_clock_sleep(&host.clock);
+
+        // Late wake-ups deliver every elapsed tick in one task_advance()
+        TASK_HOST_MUTEX_LOCK(&host.lock);
+        (void)task_clock_poll(&host.clock);
+        TASK_HOST_MUTEX_UNLOCK(&host.lock);
+
+        // Timers and the idle pass need a task_handler() per tick even when nothing was released
+        TASK_HOST_MUTEX_LOCK(&host.wake_lock);
+        host.ticks++;
+        TASK_HOST_COND_WAKE_ALL(&host.service);
+        TASK_HOST_MUTEX_UNLOCK(&host.wake_lock);
+
+        if (task_pending())
+        {
+            task_host_notify();
+        }
+    }
+
+    task_clock_close(&host.clock);
+
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * @brief
+ * Worker thread: sleep until a tick released work, then take tasks until none is left.
+ */
+TASK_HOST_THREAD(task_host_worker_main)
+{
+    uint32_t seen = 0;
+
+    (void)arg;
+
+    for (;;)
+    {
+        TASK_HOST_MUTEX_LOCK(&host.wake_lock);
+
+        while ((host.generation == seen) && (TASK_ATOMIC_LOAD(&host.stop) == 0U))
+        {
+            TASK_HOST_COND_WAIT(&host.wake, &host.wake_lock);
+        }
+
+        seen = host.generation;
+
+        TASK_HOST_MUTEX_UNLOCK(&host.wake_lock);
+
+        if (TASK_ATOMIC_LOAD(&host.stop) != 0U)
+        {
+            break;
+        }
+
+        for (uint16_t n = TASK_HOST_BATCH; (n != 0U) && task_handler_one(); n--)
+        {
+        }
+    }
+
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * @brief
+ * First worker: after every tick, the events, timers and idle pass of task_handler(),
+ * between single task claims like the other workers make.
+ */
+TASK_HOST_THREAD(task_host_service_main)
+{
+    uint32_t seen = 0;
+    uint32_t ticks = 0;
+
+    (void)arg;
+
+    for (;;)
+    {
+        TASK_HOST_MUTEX_LOCK(&host.wake_lock);
+
+        while ((host.generation == seen) && (host.ticks == ticks) && (TASK_ATOMIC_LOAD(&host.stop) == 0U))
+        {
+            TASK_HOST_COND_WAIT(&host.service, &host.wake_lock);
+        }
+
+        seen = host.generation;
+        ticks = host.ticks;
+
+        TASK_HOST_MUTEX_UNLOCK(&host.wake_lock);
+
+        if (TASK_ATOMIC_LOAD(&host.stop) != 0U)
+        {
+            break;
+        }
+
+        for (uint16_t n = TASK_HOST_BATCH; (n != 0U) && task_handler_shared(); n--)
+        {
+        }
+    }
+
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * @brief
+ * Start one thread, returns 0 on success.
+ */
+#if defined(_WIN32)
+static int task_host_spawn(task_host_thread_t *thread, LPTHREAD_START_ROUTINE entry)
+{
+    *thread = CreateThread(NULL, 0, entry, NULL, 0, NULL);
+
+    return (*thread != NULL) ? 0 : -1;
+}
+#else
+static int task_host_spawn(task_host_thread_t *thread, void *(*entry)(void *))
+{
+    return (pthread_create(thread, NULL, entry, NULL) == 0) ? 0 : -1;
+}
+#endif
+
+/**
+ * @brief
+ * Wait for a thread started by task_host_spawn() to finish.
+ */
+static void task_host_join(task_host_thread_t thread)
+{
+#if defined(_WIN32)
+    (void)WaitForSingleObject(thread, INFINITE);
+    (void)CloseHandle(thread);
+#else
+    (void)pthread_join(thread, NULL);
+#endif
+}
+
+/* Function Definitions ------------------------------------------------------*/
+
+/**
+ * @brief
+ * Start the worker threads and the tick thread. Register the tasks first.
+ * Returns 0 on success, -1 if a thread could not be created (nothing keeps running).
+ */
+int task_host_start(void)
+{
+    if (host.ticking || (host.worker_count != 0U))
+    {
+        return 0;
+    }
+
+    (void)TASK_ATOMIC_EXCHANGE(&host.stop, 0U);
+
+    while (host.worker_count < TASK_CFG_HOST_WORKERS)
+    {
+        if (task_host_spawn(&host.workers[host.worker_count],
+                            (host.worker_count == 0U) ? task_host_service_main : task_host_worker_main) != 0)
+        {
+            task_host_stop();
+            return -1;
+        }
+
+        host.worker_count++;
+    }
+
+    if (task_host_spawn(&host.tick_thread, task_host_tick_main) != 0)
+    {
+        task_host_stop();
+        return -1;
+    }
+
+    host.ticking = 1;
+
+    return 0;
+}
+
+/**
+ * @brief
+ * Stop ticking, let the workers finish their current handler and join all threads.
+ */
+void task_host_stop(void)
+{
+    (void)TASK_ATOMIC_EXCHANGE(&host.stop, 1U);
+
+    TASK_HOST_MUTEX_LOCK(&host.wake_lock);
+    TASK_HOST_COND_WAKE_ALL(&host.wake);
+    TASK_HOST_COND_WAKE_ALL(&host.service);
+    TASK_HOST_MUTEX_UNLOCK(&host.wake_lock);
+
+    if (host.ticking)
+    {
+        task_host_join(host.tick_thread);
+        host.ticking = 0;
+    }
+
+    while (host.worker_count != 0U)
+    {
+        task_host_join(host.workers[--host.worker_count]);
+    }
+}
+
+/**
+ * @brief
+ * Tick source of the timer thread, for its caught-up / lost tick counters.
+ */
+const task_clock_t *task_host_clock(void)
+{
+    return &host.clock;
+}
+
+/**
+ * @brief
+ * TASK_ENTER_CRITICAL() of the host port: excludes task_tick() on the tick thread.
+ */
+void task_host_lock(void)
+{
+    TASK_HOST_MUTEX_LOCK(&host.lock);
+}
+
+/**
+ * @brief
+ * TASK_EXIT_CRITICAL() of the host port.
+ */
+void task_host_unlock(void)
+{
+    TASK_HOST_MUTEX_UNLOCK(&host.lock);
+}
+
+/**
+ * @brief
+ * Wake the workers to take pending tasks: after a tick, or when a chain hands
+ * stages to other workers (TASK_CFG_CHAINS).
+ */
+void task_host_notify(void)
+{
+    TASK_HOST_MUTEX_LOCK(&host.wake_lock);
+    host.generation++;
+    TASK_HOST_COND_WAKE_ALL(&host.wake);
+    TASK_HOST_COND_WAKE_ALL(&host.service);
+    TASK_HOST_MUTEX_UNLOCK(&host.wake_lock);
+}
+
+#endif
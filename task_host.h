@@ -0,0 +1,34 @@
+/******************************************************************************
+ * File        : task_host.h
+ * Author      : Huseyink
+ * Date        : Oct 14, 2026
+ * Version     : 1.0.0
+ * Description : Task Frequency Scheduler Host Backend
+ ******************************************************************************/
+
+#ifndef TASK_HOST_H_
+#define TASK_HOST_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "task.h"
+#include "task_clock.h"
+
+/* Function Prototypes -------------------------------------------------------*/
+#if (TASK_CFG_HOST_WORKERS > 0)
+int task_host_start(void);
+void task_host_stop(void);
+const task_clock_t *task_host_clock(void);
+void task_host_lock(void);
+void task_host_unlock(void);
+void task_host_notify(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASK_HOST_H_ */
@@ -0,0 +1,244 @@
+/******************************************************************************
+ * File        : task_port.h
+ * Author      : Huseyink
+ * Date        : Oct 14, 2026
+ * Version     : 1.0.0
+ * Description : Task Frequency Scheduler Port Layer
+ *
+ * Target specific primitives used by task.c. Every macro may be predefined
+ * by the port (compiler command line or a forced include) to replace the
+ * portable default, e.g. LDREX/STREX sequences or an interrupt-masking
+ * implementation on Cortex-M0 parts without exclusive access instructions.
+ *
+ * This header is private to the scheduler sources and is not included by task.h.
+ ******************************************************************************/
+
+#ifndef TASK_PORT_H_
+#define TASK_PORT_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "task_config.h"
+
+/* Atomics -------------------------------------------------------------------*/
+
+/**
+ * @brief
+ * 32-bit atomic word shared between task_tick() (ISR) and task_handler().
+ *
+ * TASK_ATOMIC_U32               : storage type of an atomic word
+ * TASK_ATOMIC_LOAD(p)           : returns *p
+ * TASK_ATOMIC_FETCH_OR(p, v)    : *p |= v, returns the previous value
+ * TASK_ATOMIC_FETCH_AND(p, v)   : *p &= v, returns the previous value
+ * TASK_ATOMIC_EXCHANGE(p, v)    : *p = v, returns the previous value
+ */
+#if (TASK_CFG_READY_MASK != 0) && !defined(TASK_ATOMIC_FETCH_OR)
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define TASK_ATOMIC_U32                 _Atomic uint32_t
+#define TASK_ATOMIC_LOAD(p)             atomic_load_explicit((p), memory_order_acquire)
+#define TASK_ATOMIC_FETCH_OR(p, v)      atomic_fetch_or_explicit((p), (v), memory_order_acq_rel)
+#define TASK_ATOMIC_FETCH_AND(p, v)     atomic_fetch_and_explicit((p), (v), memory_order_acq_rel)
+#define TASK_ATOMIC_EXCHANGE(p, v)      atomic_exchange_explicit((p), (v), memory_order_acq_rel)
+#else
+#error "task_port.h: TASK_CFG_READY_MASK needs C11 atomics or port defined TASK_ATOMIC_* macros"
+#endif
+#endif
+
+/* Critical Sections ---------------------------------------------------------*/
+
+/**
+ * @brief
+ * Short interrupt-masked region used while the main loop edits the task list
+ * that task_tick() walks. Both macros appear in the same block scope, so the
+ * enter macro may declare the saved state.
+ *
+ * The default masks interrupts through PRIMASK on Cortex-M. Elsewhere it is
+ * empty, which is correct when task_tick() and task_add()/task_remove() run in
+ * the same context (host simulation); other ports must define both macros.
+ * The host backend serialises with the mutex its tick thread holds in task_tick().
+ * The RTOS backend uses the kernel's interrupt mask, which is valid in threads
+ * and in interrupts (on FreeRTOS up to configMAX_SYSCALL_INTERRUPT_PRIORITY).
+ */
+#ifndef TASK_ENTER_CRITICAL
+#if (TASK_CFG_HOST_WORKERS > 0)
+void task_host_lock(void);
+void task_host_unlock(void);
+void task_host_notify(void);
+#define TASK_ENTER_CRITICAL()   task_host_lock()
+#define TASK_EXIT_CRITICAL()    task_host_unlock()
+#elif (TASK_CFG_RTOS == TASK_RTOS_FREERTOS)
+#include <FreeRTOS.h>
+#define TASK_ENTER_CRITICAL()   UBaseType_t task_primask_ = portSET_INTERRUPT_MASK_FROM_ISR()
+#define TASK_EXIT_CRITICAL()    portCLEAR_INTERRUPT_MASK_FROM_ISR(task_primask_)
+#elif (TASK_CFG_RTOS == TASK_RTOS_ZEPHYR)
+#include <zephyr/kernel.h>
+#define TASK_ENTER_CRITICAL()   unsigned int task_primask_ = irq_lock()
+#define TASK_EXIT_CRITICAL()    irq_unlock(task_primask_)
+#elif defined(__GNUC__) && defined(__ARM_ARCH) && defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+#define TASK_ENTER_CRITICAL()   uint32_t task_primask_; \
+                                __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (task_primask_) :: "memory")
+#define TASK_EXIT_CRITICAL()    __asm volatile ("msr primask, %0" :: "r" (task_primask_) : "memory")
+#else
+#define TASK_ENTER_CRITICAL()   do { } while (0)
+#define TASK_EXIT_CRITICAL()    do { } while (0)
+#endif
+#endif
+
+/* Memory Barrier ------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Full memory barrier ordering the slot and index accesses of the event queues
+ * (DMB on Cortex-M). Ports without GCC builtins or C11 atomics define it.
+ */
+#ifndef TASK_MEMORY_BARRIER
+#if defined(__GNUC__) || defined(__clang__)
+#define TASK_MEMORY_BARRIER()   __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define TASK_MEMORY_BARRIER()   atomic_thread_fence(memory_order_seq_cst)
+#elif (TASK_CFG_EVENTS != 0)
+#error "task_port.h: TASK_CFG_EVENTS needs a TASK_MEMORY_BARRIER() definition"
+#endif
+#endif
+
+/* Software Interrupts -------------------------------------------------------*/
+
+/**
+ * @brief
+ * Pend the software interrupt serving preemptive level `level` (TASK_CFG_PREEMPT_LEVELS).
+ * Typically spare NVIC vectors with descending priority, all below the tick interrupt:
+ *   #define TASK_PORT_PEND(level)  NVIC_SetPendingIRQ((IRQn_Type)(TASK_IRQN_BASE + (level)))
+ * The RTOS backend wakes the thread of the level instead.
+ */
+#if (TASK_CFG_PREEMPT_LEVELS > 0) && (TASK_CFG_RTOS != TASK_RTOS_NONE) && !defined(TASK_PORT_PEND)
+void task_rtos_pend(uint8_t level);
+#define TASK_PORT_PEND(level)   task_rtos_pend(level)
+#endif
+
+#if (TASK_CFG_PREEMPT_LEVELS > 0) && !defined(TASK_PORT_PEND)
+#error "task_port.h: TASK_CFG_PREEMPT_LEVELS needs a TASK_PORT_PEND(level) definition"
+#endif
+
+/* Core Identification -------------------------------------------------------*/
+
+/**
+ * @brief
+ * Index (0..TASK_CFG_CORES-1) of the executing core, selects its scheduler instance:
+ *   RP2040 : #define TASK_PORT_CORE_ID()  (*(volatile uint32_t *)0xD0000000UL)   (SIO CPUID)
+ *   STM32H7: #define TASK_PORT_CORE_ID()  ((((SCB->CPUID >> 4) & 0xFFFU) == 0xC27U) ? 0U : 1U)
+ */
+#if (TASK_CFG_CORES > 1) && !defined(TASK_PORT_CORE_ID)
+#error "task_port.h: TASK_CFG_CORES > 1 needs a TASK_PORT_CORE_ID() definition"
+#endif
+
+/* Bit Scan ------------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Index of the least significant set bit of a non-zero 32-bit value
+ * (RBIT + CLZ on ARMv7-M, a short loop on cores without CLZ).
+ */
+#ifndef TASK_CTZ
+#if defined(__GNUC__) || defined(__clang__)
+#define TASK_CTZ(x)     ((uint8_t)__builtin_ctz(x))
+#else
+static inline uint8_t task_port_ctz(uint32_t x)
+{
+    uint8_t n = 0;
+
+    while ((x & 1U) == 0U)
+    {
+        x >>= 1;
+        n++;
+    }
+
+    return n;
+}
+#define TASK_CTZ(x)     task_port_ctz(x)
+#endif
+#endif
+
+/**
+ * @brief
+ * Number of leading zero bits of a non-zero 32-bit value.
+ */
+#ifndef TASK_CLZ
+#if defined(__GNUC__) || defined(__clang__)
+#define TASK_CLZ(x)     ((uint8_t)__builtin_clz(x))
+#else
+static inline uint8_t task_port_clz(uint32_t x)
+{
+    uint8_t n = 0;
+
+    while ((x & 0x80000000UL) == 0U)
+    {
+        x <<= 1;
+        n++;
+    }
+
+    return n;
+}
+#define TASK_CLZ(x)     task_port_clz(x)
+#endif
+#endif
+
+/* Placement -----------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Section attributes for zero wait state memory, empty (default sections) by default.
+ *
+ * TASK_PORT_FAST_CODE : task_tick(), task_handler(), task_handler_one(),
+ *                       task_preempt_dispatch(), task_queue_post() and their helpers
+ * TASK_PORT_FAST_DATA : the scheduler instances; the section must be zeroed at startup
+ *
+ * STM32H7 / i.MX RT with ITCM and DTCM sections in the linker script:
+ *   #define TASK_PORT_FAST_CODE  __attribute__((section(".itcm_text")))
+ *   #define TASK_PORT_FAST_DATA  __attribute__((section(".dtcm_bss")))
+ * GNU ld inserts long-branch veneers for calls between flash and ITCM.
+ */
+#ifndef TASK_PORT_FAST_CODE
+#define TASK_PORT_FAST_CODE
+#endif
+
+#ifndef TASK_PORT_FAST_DATA
+#define TASK_PORT_FAST_DATA
+#endif
+
+/**
+ * @brief
+ * Aligns a scheduler field group to TASK_CFG_CACHE_LINE bytes, empty when it is 0.
+ */
+#ifndef TASK_CACHE_ALIGNED
+#if (TASK_CFG_CACHE_LINE == 0)
+#define TASK_CACHE_ALIGNED
+#elif defined(__GNUC__) || defined(__clang__)
+#define TASK_CACHE_ALIGNED      __attribute__((aligned(TASK_CFG_CACHE_LINE)))
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define TASK_CACHE_ALIGNED      _Alignas(TASK_CFG_CACHE_LINE)
+#else
+#error "task_port.h: TASK_CFG_CACHE_LINE needs a TASK_CACHE_ALIGNED definition"
+#endif
+#endif
+
+/* Cycle Counter -------------------------------------------------------------*/
+
+/**
+ * @brief
+ * Free-running 32-bit cycle counter used by TASK_CFG_STATS, TASK_CFG_TRACE and TASK_CFG_LOAD.
+ *
+ * Defaults to DWT->CYCCNT on Cortex-M3/M4/M7/M33 (the application enables
+ * the counter through CoreDebug->DEMCR and DWT->CTRL). Cores without DWT, such
+ * as Cortex-M0, can use a timer count; host builds define it to a clock read.
+ */
+#if ((TASK_CFG_STATS != 0) || (TASK_CFG_TRACE != 0) || (TASK_CFG_LOAD != 0)) && !defined(TASK_PORT_CYCLES)
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define TASK_PORT_CYCLES()      (*(volatile uint32_t *)0xE0001004UL)
+#else
+#error "task_port.h: TASK_CFG_STATS, TASK_CFG_TRACE and TASK_CFG_LOAD need a TASK_PORT_CYCLES() definition for this target"
+#endif
+#endif
+
+#endif /* TASK_PORT_H_ */
@@ -0,0 +1,361 @@
+/******************************************************************************
+ * File        : task_rtos.c
+ * Author      : Huseyink
+ * Date        : Oct 14, 2026
+ * Version     : 1.0.0
+ * Description : Task Frequency Scheduler RTOS Backend
+ *
+ * Runs the scheduler on FreeRTOS or Zephyr threads instead of a bare metal
+ * main loop. A periodic kernel timer replaces the tick interrupt (a FreeRTOS
+ * timer service callback, a Zephyr k_timer in the system clock interrupt);
+ * both reload on absolute kernel ticks, so the schedule does not drift.
+ * Each preemptive level (TASK_CFG_PREEMPT_LEVELS) becomes a native thread with
+ * a rate monotonic kernel priority: TASK_PORT_PEND(level) wakes it through a
+ * direct-to-task notification (FreeRTOS) or a semaphore (Zephyr), and it calls
+ * task_preempt_dispatch(level). A background thread one step below the levels
+ * runs task_handler() for the cooperative levels, timers, events and the idle
+ * hook. Only RM dispatch with TASK_CFG_PREEMPT_LEVELS gives rates threads of their
+ * own: by default every rate runs on the background thread, cooperatively as in
+ * a bare metal main loop. Thread n gets TASK_CFG_RTOS_STACK_LEVEL(n) bytes of
+ * stack (TASK_CFG_RTOS_STACK unless overridden), carved from one static pool on
+ * FreeRTOS and one stack object per thread on Zephyr.
+ *
+ * Usage:
+ *  - Build with -DTASK_CFG_RTOS=TASK_RTOS_FREERTOS (or TASK_RTOS_ZEPHYR), typically
+ *    with -DTASK_CFG_READY_MASK=1 -DTASK_CFG_DISPATCH=TASK_DISPATCH_RM -DTASK_CFG_PREEMPT_LEVELS=n
+ *  - Register tasks, then call `task_rtos_start()` (before vTaskStartScheduler() on FreeRTOS)
+ *  - Do not call task_tick() or task_handler() from the application
+ *
+ * Limitations:
+ *  - FreeRTOS needs configSUPPORT_STATIC_ALLOCATION and configUSE_TIMERS, a timer
+ *    task priority above TASK_CFG_RTOS_PRIORITY, and a configTICK_RATE_HZ that is a
+ *    multiple of TASK_CFG_TICK_HZ; Zephyr checks CONFIG_SYS_CLOCK_TICKS_PER_SEC at build time
+ *  - Unlike the interrupt levels, a level thread may block; the less urgent levels run
+ *    meanwhile, and its own releases wait for it (and count as overflow as on the target)
+ *  - Zephyr defines a stack object per thread, for up to 8 preemptive levels
+ *
+ ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "task_rtos.h"
+#include "task_port.h"
+
+#if (TASK_CFG_RTOS != TASK_RTOS_NONE)
+
+#if (TASK_CFG_RTOS == TASK_RTOS_FREERTOS)
+#include <FreeRTOS.h>
+#include <timers.h>     // Pulls in the kernel's task.h from its own directory
+#else
+#include <zephyr/kernel.h>
+#endif
+
+/* Defines/macros ------------------------------------------------------------*/
+
+// Backend threads: one per preemptive level, then the background thread
+#define TASK_RTOS_BACKGROUND    (TASK_CFG_PREEMPT_LEVELS)
+#define TASK_RTOS_THREADS       (TASK_CFG_PREEMPT_LEVELS + 1)
+
+#if (TASK_CFG_RTOS == TASK_RTOS_FREERTOS)
+#define TASK_RTOS_THREAD(name)  static void name(void *arg)
+#define TASK_RTOS_PRIO(thread)  ((UBaseType_t)(TASK_CFG_RTOS_PRIORITY - (thread)))
+#define TASK_RTOS_STACK_DEPTH(thread) (TASK_CFG_RTOS_STACK_LEVEL(thread) / sizeof(StackType_t))
+
+// Pool size in stack words: up to 33 threads (32 levels and the background thread)
+#define TASK_RTOS_STACK_AT(thread) (((thread) < TASK_RTOS_THREADS) ? TASK_RTOS_STACK_DEPTH(thread) : 0U)
+#define TASK_RTOS_STACK_SUM8(first) \
+    (TASK_RTOS_STACK_AT((first) + 0) + TASK_RTOS_STACK_AT((first) + 1) + TASK_RTOS_STACK_AT((first) + 2) + \
+     TASK_RTOS_STACK_AT((first) + 3) + TASK_RTOS_STACK_AT((first) + 4) + TASK_RTOS_STACK_AT((first) + 5) + \
+     TASK_RTOS_STACK_AT((first) + 6) + TASK_RTOS_STACK_AT((first) + 7))
+#define TASK_RTOS_STACK_POOL \
+    (TASK_RTOS_STACK_SUM8(0) + TASK_RTOS_STACK_SUM8(8) + TASK_RTOS_STACK_SUM8(16) + TASK_RTOS_STACK_SUM8(24) + \
+     TASK_RTOS_STACK_AT(32))
+
+// Context test for the notification call, available on the Cortex-M ports
+#ifndef TASK_RTOS_IN_ISR
+#define TASK_RTOS_IN_ISR()      (xPortIsInsideInterrupt() != pdFALSE)
+#endif
+#else
+#define TASK_RTOS_THREAD(name)  static void name(void *arg, void *unused1, void *unused2)
+#define TASK_RTOS_PRIO(thread)  ((int)(TASK_CFG_RTOS_PRIORITY + (thread)))
+
+// One stack object per thread: Zephyr aligns, guards and grants each on its own
+#define TASK_RTOS_STACK_DEFINE(thread) \
+    static K_THREAD_STACK_DEFINE(task_rtos_stack_##thread, TASK_CFG_RTOS_STACK_LEVEL(thread))
+
+#if (TASK_RTOS_THREADS > 9)
+#error "task_rtos.c: Zephyr stacks are defined for up to 8 preemptive levels"
+#endif
+
+#if ((CONFIG_SYS_CLOCK_TICKS_PER_SEC % TASK_CFG_TICK_HZ) != 0)
+#error "task_rtos.c: CONFIG_SYS_CLOCK_TICKS_PER_SEC must be a multiple of TASK_CFG_TICK_HZ"
+#endif
+#endif
+
+// Idle work and posted events are only seen by task_handler(), wake it on every tick then
+#if (TASK_CFG_IDLE != 0) || (TASK_CFG_EVENTS != 0)
+#define TASK_RTOS_TICK_WAKE     (1)
+#else
+#define TASK_RTOS_TICK_WAKE     (0)
+#endif
+
+/* Types ---------------------------------------------------------------------*/
+
+/**
+ * @brief
+ * RTOS backend state.
+ */
+typedef struct
+{
+#if (TASK_CFG_RTOS == TASK_RTOS_FREERTOS)
+    TaskHandle_t threads[TASK_RTOS_THREADS];       // NULL until created
+    StaticTask_t thread_buffers[TASK_RTOS_THREADS];
+    TimerHandle_t timer;                           // Calls task_tick()
+    StaticTimer_t timer_buffer;
+#else
+    struct k_thread threads[TASK_RTOS_THREADS];
+    struct k_sem wake[TASK_RTOS_THREADS];          // Given by task_rtos_wake()
+    struct k_timer timer;                          // Calls task_tick()
+#endif
+    volatile uint8_t started;                      // Set by task_rtos_start()
+} task_rtos_t;
+
+/* Private Variables ---------------------------------------------------------*/
+
+static task_rtos_t rtos;
+
+// Stacks of all backend threads, level 0 first
+#if (TASK_CFG_RTOS == TASK_RTOS_FREERTOS)
+static StackType_t task_rtos_stacks[TASK_RTOS_STACK_POOL];
+#else
+TASK_RTOS_STACK_DEFINE(0);
+#if (TASK_RTOS_THREADS > 1)
+TASK_RTOS_STACK_DEFINE(1);
+#endif
+#if (TASK_RTOS_THREADS > 2)
+TASK_RTOS_STACK_DEFINE(2);
+#endif
+#if (TASK_RTOS_THREADS > 3)
+TASK_RTOS_STACK_DEFINE(3);
+#endif
+#if (TASK_RTOS_THREADS > 4)
+TASK_RTOS_STACK_DEFINE(4);
+#endif
+#if (TASK_RTOS_THREADS > 5)
+TASK_RTOS_STACK_DEFINE(5);
+#endif
+#if (TASK_RTOS_THREADS > 6)
+TASK_RTOS_STACK_DEFINE(6);
+#endif
+#if (TASK_RTOS_THREADS > 7)
+TASK_RTOS_STACK_DEFINE(7);
+#endif
+#if (TASK_RTOS_THREADS > 8)
+TASK_RTOS_STACK_DEFINE(8);
+#endif
+
+static k_thread_stack_t *const task_rtos_stacks[TASK_RTOS_THREADS] =
+{
+    task_rtos_stack_0,
+#if (TASK_RTOS_THREADS > 1)
+    task_rtos_stack_1,
+#endif
+#if (TASK_RTOS_THREADS > 2)
+    task_rtos_stack_2,
+#endif
+#if (TASK_RTOS_THREADS > 3)
+    task_rtos_stack_3,
+#endif
+#if (TASK_RTOS_THREADS > 4)
+    task_rtos_stack_4,
+#endif
+#if (TASK_RTOS_THREADS > 5)
+    task_rtos_stack_5,
+#endif
+#if (TASK_RTOS_THREADS > 6)
+    task_rtos_stack_6,
+#endif
+#if (TASK_RTOS_THREADS > 7)
+    task_rtos_stack_7,
+#endif
+#if (TASK_RTOS_THREADS > 8)
+    task_rtos_stack_8,
+#endif
+};
+#endif
+
+/* Private Functions ---------------------------------------------------------*/
+
+/**
+ * @brief
+ * Wake a backend thread, from a thread or an interrupt. Wake-ups before the
+ * thread waits are kept; several of them collapse into one.
+ */
+static void task_rtos_wake(uint8_t thread)
+{
+    if (!rtos.started)
+    {
+        return;
+    }
+
+#if (TASK_CFG_RTOS == TASK_RTOS_FREERTOS)
+    if (TASK_RTOS_IN_ISR())
+    {
+        BaseType_t woken = pdFALSE;
+
+        vTaskNotifyGiveFromISR(rtos.threads[thread], &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+    else
+    {
+        (void)xTaskNotifyGive(rtos.threads[thread]);
+    }
+#else
+    k_sem_give(&rtos.wake[thread]);
+#endif
+}
+
+/**
+ * @brief
+ * Block a backend thread until task_rtos_wake() is called for it.
+ */
+static void task_rtos_wait(uint8_t thread)
+{
+#if (TASK_CFG_RTOS == TASK_RTOS_FREERTOS)
+    (void)thread;
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#else
+    (void)k_sem_take(&rtos.wake[thread], K_FOREVER);
+#endif
+}
+
+/**
+ * @brief
+ * Backend thread: a preemptive level, or the background thread running task_handler().
+ */
+TASK_RTOS_THREAD(task_rtos_main)
+{
+    uint8_t thread = (uint8_t)(uintptr_t)arg;
+
+#if (TASK_CFG_RTOS == TASK_RTOS_ZEPHYR)
+    (void)unused1;
+    (void)unused2;
+#endif
+
+    for (;;)
+    {
+        task_rtos_wait(thread);
+
+#if (TASK_CFG_PREEMPT_LEVELS > 0)
+        if (thread != TASK_RTOS_BACKGROUND)
+        {
+            task_preempt_dispatch(thread);
+            continue;
+        }
+#endif
+
+        task_handler();
+    }
+}
+
+/**
+ * @brief
+ * Kernel timer callback: the RTOS replacement of the tick interrupt.
+ */
+#if (TASK_CFG_RTOS == TASK_RTOS_FREERTOS)
+static void task_rtos_tick(TimerHandle_t timer)
+#else
+static void task_rtos_tick(struct k_timer *timer)
+#endif
+{
+    (void)timer;
+
+    // Preemptive levels are woken from task_tick() through TASK_PORT_PEND()
+    task_tick();
+
+    if (TASK_RTOS_TICK_WAKE || task_pending())
+    {
+        task_rtos_wake(TASK_RTOS_BACKGROUND);
+    }
+}
+
+/* Function Definitions ------------------------------------------------------*/
+
+/**
+ * @brief
+ * Create the backend threads and start the tick timer. Register the tasks first.
+ * Returns 0 on success, -1 if the kernel tick rate does not fit TASK_CFG_TICK_HZ
+ * or the timer could not be started (nothing ticks then).
+ */
+int task_rtos_start(void)
+{
+    if (rtos.started)
+    {
+        return 0;
+    }
+
+#if (TASK_CFG_RTOS == TASK_RTOS_FREERTOS)
+    if ((configTICK_RATE_HZ < TASK_CFG_TICK_HZ) || ((configTICK_RATE_HZ % TASK_CFG_TICK_HZ) != 0U))
+    {
+        return -1;
+    }
+
+    rtos.timer = xTimerCreateStatic("task", (TickType_t)(configTICK_RATE_HZ / TASK_CFG_TICK_HZ), pdTRUE,
+                                    NULL, task_rtos_tick, &rtos.timer_buffer);
+
+    if (rtos.timer == NULL)
+    {
+        return -1;
+    }
+
+    uint32_t offset = 0;
+
+    for (uint8_t i = 0; i < TASK_RTOS_THREADS; i++)
+    {
+        rtos.threads[i] = xTaskCreateStatic(task_rtos_main, "task", TASK_RTOS_STACK_DEPTH(i), (void *)(uintptr_t)i,
+                                            TASK_RTOS_PRIO(i), &task_rtos_stacks[offset], &rtos.thread_buffers[i]);
+        offset += TASK_RTOS_STACK_DEPTH(i);
+    }
+
+    rtos.started = 1;
+
+    if (xTimerStart(rtos.timer, 0) != pdPASS)
+    {
+        return -1;
+    }
+#else
+    for (uint8_t i = 0; i < TASK_RTOS_THREADS; i++)
+    {
+        k_sem_init(&rtos.wake[i], 0, 1);
+    }
+
+    rtos.started = 1;
+
+    for (uint8_t i = 0; i < TASK_RTOS_THREADS; i++)
+    {
+        (void)k_thread_create(&rtos.threads[i], task_rtos_stacks[i], TASK_CFG_RTOS_STACK_LEVEL(i),
+                              task_rtos_main, (void *)(uintptr_t)i, NULL, NULL, TASK_RTOS_PRIO(i), 0, K_NO_WAIT);
+    }
+
+    k_timer_init(&rtos.timer, task_rtos_tick, NULL);
+    k_timer_start(&rtos.timer, K_TICKS(CONFIG_SYS_CLOCK_TICKS_PER_SEC / TASK_CFG_TICK_HZ),
+                  K_TICKS(CONFIG_SYS_CLOCK_TICKS_PER_SEC / TASK_CFG_TICK_HZ));
+#endif
+
+    return 0;
+}
+
+#if (TASK_CFG_PREEMPT_LEVELS > 0)
+/**
+ * @brief
+ * TASK_PORT_PEND() of the RTOS port: wakes the thread of a preemptive level.
+ */
+void task_rtos_pend(uint8_t level)
+{
+    if (level < TASK_CFG_PREEMPT_LEVELS)
+    {
+        task_rtos_wake(level);
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,31 @@
+/******************************************************************************
+ * File        : task_rtos.h
+ * Author      : Huseyink
+ * Date        : Oct 14, 2026
+ * Version     : 1.0.0
+ * Description : Task Frequency Scheduler RTOS Backend
+ ******************************************************************************/
+
+#ifndef TASK_RTOS_H_
+#define TASK_RTOS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "task.h"
+
+/* Function Prototypes -------------------------------------------------------*/
+#if (TASK_CFG_RTOS != TASK_RTOS_NONE)
+int task_rtos_start(void);
+#if (TASK_CFG_PREEMPT_LEVELS > 0)
+void task_rtos_pend(uint8_t level);
+#endif
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASK_RTOS_H_ */
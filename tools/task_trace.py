@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+Decode a TASK_CFG_TRACE event stream into a Chrome trace (JSON).
+
+The input is the raw output of task_trace_read(), 8 bytes per event, as written
+to a file or captured from a UART / RTT channel, in read order. The output
+opens in Perfetto (ui.perfetto.dev) or chrome://tracing. There is one track per
+task, handler runs are slices, and releases and overflows are instant markers.
+
+    python3 tools/task_trace.py trace.bin --clock-hz 480000000 -o trace.json
+    python3 tools/task_trace.py trace.bin --clock-hz 480e6 --name 8=adc --name 9=link
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+# task_trace_event_t: uint32_t time, uint16_t task, uint8_t type, uint8_t core
+EVENT = struct.Struct("<IHBB")
+
+# type: event in the low nibble, core owning the task index in the high one
+TYPE_MASK = 0x0F
+OWNER_SHIFT = 4
+
+RELEASE, START, END, OVERFLOW = range(4)
+
+BUILTIN = ["1Hz", "2Hz", "5Hz", "10Hz", "20Hz", "50Hz", "100Hz", "200Hz"]
+
+
+def read_events(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    usable = len(data) - (len(data) % EVENT.size)
+
+    if usable != len(data):
+        print("warning: %d trailing bytes ignored" % (len(data) - usable), file=sys.stderr)
+
+    return [EVENT.unpack_from(data, offset) for offset in range(0, usable, EVENT.size)]
+
+
+def task_name(index, names):
+    if index in names:
+        return names[index]
+
+    return BUILTIN[index] if index < len(BUILTIN) else "task %d" % index
+
+
+def convert(events, clock_hz, names):
+    out = []
+    seen = set()
+    last = {}                             # Per core: previous raw stamp and its unwrapped time
+    depth = {}                            # Open slices per (core, task), to drop unmatched ends
+
+    for time, task, kind, core in events:
+        owner = kind >> OWNER_SHIFT
+        kind &= TYPE_MASK
+
+        # 32-bit cycle stamps wrap; unwrap with the signed distance to the previous stamp of
+        # the core, so a stamp slightly behind the previous one is not taken for a wrap
+        prev, total = last.get(core, (time, time))
+        d = (time - prev) & 0xFFFFFFFF
+        if d >= 1 << 31:
+            d -= 1 << 32
+        total += d
+        last[core] = (time, total)
+
+        ts = total * 1e6 / clock_hz
+
+        # A task stolen from another core gets its own track on the core that ran it
+        if owner == core:
+            tid, name = task, task_name(task, names)
+        else:
+            tid, name = ((owner + 1) << 16) | task, "%s (core %d)" % (task_name(task, names), owner)
+        key = (core, tid)
+
+        if key not in seen:
+            seen.add(key)
+            out.append({"ph": "M", "name": "thread_name", "pid": core, "tid": tid,
+                        "args": {"name": name}})
+
+        if kind == START:
+            depth[key] = depth.get(key, 0) + 1
+            out.append({"ph": "B", "name": name, "pid": core, "tid": tid, "ts": ts})
+        elif kind == END:
+            # The start may have been overwritten in the ring before it was read
+            if depth.get(key, 0) == 0:
+                continue
+            depth[key] -= 1
+            out.append({"ph": "E", "pid": core, "tid": tid, "ts": ts})
+        elif kind in (RELEASE, OVERFLOW):
+            out.append({"ph": "i", "s": "t", "name": "release" if kind == RELEASE else "overflow",
+                        "pid": core, "tid": tid, "ts": ts})
+        else:
+            print("warning: unknown event type %d" % kind, file=sys.stderr)
+
+    for core in sorted({core for core, _ in seen}):
+        out.append({"ph": "M", "name": "process_name", "pid": core, "args": {"name": "core %d" % core}})
+
+    return {"traceEvents": out, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="raw task_trace_event_t stream")
+    parser.add_argument("-o", "--output", help="JSON file (default: stdout)")
+    parser.add_argument("--clock-hz", type=float, required=True, help="TASK_PORT_CYCLES() rate in Hz")
+    parser.add_argument("--name", action="append", default=[], metavar="INDEX=NAME",
+                        help="name of a task index, e.g. 8=adc (repeatable)")
+    args = parser.parse_args()
+
+    names = {}
+    for item in args.name:
+        index, _, name = item.partition("=")
+        names[int(index, 0)] = name
+
+    trace = convert(read_events(args.input), args.clock_hz, names)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())